@@ -0,0 +1,250 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Keep the compiler from optimizing away a computed value, or from hoisting its computation out of a loop.
+ * @param value Value to keep.
+ */
+template<class T>
+inline void
+doNotOptimize(
+        T const &value
+)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Output stream buffer discarding everything written to it, to measure formatting without terminal I/O.
+ */
+class NullBuffer
+        : public std::streambuf
+{
+
+protected:
+
+    int_type
+    overflow(
+            int_type const c
+    ) override
+    {
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize
+    xsputn(
+            char const *,
+            std::streamsize const count
+    ) override
+    {
+        return count;
+    }
+
+};
+
+/**
+ * Statistics of a single benchmark, in nanoseconds per operation.
+ */
+struct BenchmarkResult
+{
+    std::string name;
+    std::uint64_t batch{0};         ///<        Operations timed together per sample
+    std::size_t samples{0};
+    double items{1};                ///<        Work items per operation, e.g. bodies per system step
+    double median{0};               ///< [ns]
+    double p99{0};                  ///< [ns]
+    double mad{0};                  ///< [ns]   Median absolute deviation from the median
+    double min{0};                  ///< [ns]
+    double mean{0};                 ///< [ns]
+};
+
+/**
+ * Minimal benchmark harness.
+ *
+ * Each benchmark is warmed up, then the count of operations per sample is calibrated, so a single sample takes long
+ * enough to be measured accurately with `std::chrono::steady_clock`. Finally, a fixed count of samples is taken. Robust
+ * statistics (median and median absolute deviation) are reported, since timings are skewed by preemption and other
+ * noise towards higher values.
+ */
+class Benchmark
+{
+
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param filter Only run benchmarks whose name contains this string.
+     * @param samples Count of samples to take per benchmark, at least 1.
+     * @param minimumSampleTime Minimum wall time of a single sample.
+     */
+    explicit Benchmark(
+            std::string filter = {},
+            std::size_t const samples = 51,
+            Clock::duration const minimumSampleTime = std::chrono::milliseconds{2}
+    )
+            : mFilter{std::move(filter)}
+            , mSamples{samples}
+            , mMinimumSampleTime{minimumSampleTime}
+    {
+        assert(mSamples > 0);
+    }
+
+    /**
+     * Run a benchmark, unless filtered out.
+     * @param name Benchmark name.
+     * @param items Count of work items per operation, to report throughput per item.
+     * @param operation Operation to measure. Should pass its result to `doNotOptimize()`.
+     */
+    template<class TFun>
+    void
+    run(
+            std::string_view const name,
+            double const items,
+            TFun &&operation
+    )
+    {
+        if (std::string_view::npos == name.find(mFilter))
+        {
+            return;
+        }
+
+        auto measure = [&](std::uint64_t const batch) {
+            auto const begin = Clock::now();
+            for (std::uint64_t i = 0; i < batch; i++)
+            {
+                operation();
+            }
+            return Clock::now() - begin;
+        };
+
+        // Warm up caches, branch predictors and CPU clock, and calibrate batch size on the way:
+        std::uint64_t batch = 1;
+        auto const warmupEnd = Clock::now() + 10 * mMinimumSampleTime;
+        while (true)
+        {
+            auto const elapsed = measure(batch);
+            if (elapsed >= mMinimumSampleTime && Clock::now() >= warmupEnd)
+            {
+                break;
+            }
+            if (elapsed < mMinimumSampleTime)
+            {
+                batch *= 2;
+            }
+        }
+
+        std::vector<double> times(mSamples);
+        for (auto &time : times)
+        {
+            time = std::chrono::duration<double, std::nano>{measure(batch)}.count() / batch;
+        }
+
+        BenchmarkResult result;
+        result.name = name;
+        result.batch = batch;
+        result.samples = mSamples;
+        result.items = items;
+        result.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+
+        std::sort(times.begin(), times.end());
+        result.min = times.front();
+        result.median = percentile(times, 0.5);
+        result.p99 = percentile(times, 0.99);
+
+        for (auto &time : times)
+        {
+            time = std::abs(time - result.median);
+        }
+        std::sort(times.begin(), times.end());
+        result.mad = percentile(times, 0.5);
+
+        mResults.push_back(result);
+        if (mOnResult)
+        {
+            mOnResult(result);
+        }
+    }
+
+    /**
+     * Set a function called after each benchmark, e.g. to report progress.
+     * @param onResult Function receiving each result.
+     */
+    void
+    onResult(
+            std::function<void(BenchmarkResult const &)> onResult
+    )
+    {
+        mOnResult = std::move(onResult);
+    }
+
+    /**
+     * @return All results so far.
+     */
+    std::vector<BenchmarkResult> const &
+    results() const
+    {
+        return mResults;
+    }
+
+    /**
+     * Write all results as JSON.
+     * @param os Stream to write to.
+     */
+    void
+    json(
+            std::ostream &os
+    ) const
+    {
+        os << "{\"unit\":\"ns\",\"benchmarks\":[";
+        for (std::size_t i = 0; i < mResults.size(); i++)
+        {
+            auto const &result = mResults[i];
+            os << (i > 0 ? "," : "") << "\n  {\"name\":\"" << result.name << "\",\"batch\":" << result.batch
+               << ",\"samples\":" << result.samples << ",\"items\":" << result.items << ",\"median\":"
+               << result.median << ",\"p99\":" << result.p99 << ",\"mad\":" << result.mad << ",\"min\":" << result.min
+               << ",\"mean\":" << result.mean << ",\"median_per_item\":" << result.median / result.items << "}";
+        }
+        os << "\n]}\n";
+    }
+
+private:
+
+    std::string mFilter;
+    std::size_t mSamples;
+    Clock::duration mMinimumSampleTime;
+    std::vector<BenchmarkResult> mResults;
+    std::function<void(BenchmarkResult const &)> mOnResult;
+
+    /**
+     * Nearest-rank percentile.
+     * @param sorted Values in ascending order, not empty.
+     * @param p Percentile in [0, 1].
+     * @return Percentile value.
+     */
+    static double
+    percentile(
+            std::vector<double> const &sorted,
+            double const p
+    )
+    {
+        auto const rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+};
@@ -0,0 +1,242 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include "Benchmark.h"
+#include <orbital/graphics/Graphics.h>
+#include <orbital/math/elementary.h>
+#include <orbital/math/Ellipse.h>
+#include <orbital/math/EllipseBatch.h>
+#include <orbital/math/lambert.h>
+#include <orbital/physical/System.h>
+
+namespace
+{
+
+/**
+ * Create a system of bodies on spread out orbits around a sun.
+ * @param count Count of orbiting bodies.
+ * @return System.
+ */
+std::unique_ptr<System>
+makeSystem(
+        std::size_t const count
+)
+{
+    auto system = std::make_unique<System>(Body{"Sun", 1.9884e30, 6.96e8, 0, 0}, 60 * 60);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        system->add(Body{"Body", 1e20, 1e6, au(0.4 + 30.0 * i / count), 0.2 * (i % 8) / 8});
+    }
+    return system;
+}
+
+}
+
+int
+main(
+        int argc,
+        char **argv
+)
+{
+    std::string filter;
+    std::string output;
+    std::size_t samples = 51;
+
+    // Options come in pairs of name and value:
+    bool valid = argc % 2 == 1;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string_view const option{argv[i]};
+        if ("--filter"sv == option)
+        {
+            filter = argv[i + 1];
+        }
+        else if ("--samples"sv == option)
+        {
+            // Unlike std::stoul(), rejects signs, which would wrap around, and trailing characters:
+            std::string_view const value{argv[i + 1]};
+            auto const [end, error] = std::from_chars(value.data(), value.data() + value.size(), samples);
+            valid = valid && std::errc{} == error && value.data() + value.size() == end;
+        }
+        else if ("--out"sv == option)
+        {
+            output = argv[i + 1];
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    // Statistics need at least one sample:
+    if (!valid || samples < 1)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--samples <count>] [--out <file.json>]"
+                  << std::endl;
+        return 1;
+    }
+
+    Benchmark benchmark{filter, samples};
+    benchmark.onResult([](BenchmarkResult const &result) {
+        std::cerr << fmt::format("{:<32} median {:>12.1f} ns  p99 {:>12.1f} ns  mad {:>10.1f} ns  ({:.2f} ns/item)\n",
+                result.name, result.median, result.p99, result.mad, result.median / result.items);
+    });
+
+    // Physics:
+    {
+        Body body{"Earth", 5.97e24, 6.37e6, au(1), 0.0167};
+        benchmark.run("Body::step", 1, [&] {
+            body.step(1.9884e30, 60 * 60);
+            doNotOptimize(body.getPosition());
+        });
+
+        for (std::size_t count : {10, 1000, 1000000})
+        {
+            auto system = makeSystem(count);
+            benchmark.run(fmt::format("System::stepSimulation/{}", count), count, [&] {
+                system->stepSimulation();
+            });
+        }
+    }
+
+    // Ellipse math:
+    {
+        Ellipse<Decimal> ellipse{2, 0.5};
+        Rectangle<Decimal> rect{{1, 0.1}, {4, 4}};
+        Transform<Decimal> transform;
+        benchmark.run("Ellipse::clip", 1, [&] {
+            doNotOptimize(rect);
+            doNotOptimize(ellipse.clip(rect, transform));
+        });
+
+        vec point{1.5, 0.8};
+        benchmark.run("Ellipse::projection", 1, [&] {
+            doNotOptimize(point);
+            doNotOptimize(ellipse.projection(point));
+        });
+
+        Radian<Decimal> ts{0.3};
+        Radian<Decimal> te{2.5};
+        benchmark.run("Ellipse::arcLength", 1, [&] {
+            doNotOptimize(ts);
+            doNotOptimize(ellipse.arcLength(ts, te));
+        });
+
+        benchmark.run("Ellipse::point", 1, [&] {
+            doNotOptimize(ts);
+            doNotOptimize(ellipse.point(ts));
+        });
+        benchmark.run("Ellipse::point/FastTrig", 1, [&] {
+            doNotOptimize(ts);
+            doNotOptimize(ellipse.point<FastTrig>(ts));
+        });
+
+        // Batched over many orbits:
+        std::vector<Ellipse<Decimal>> orbits;
+        std::vector<vec> points;
+        for (std::size_t i = 0; i < 1000; i++)
+        {
+            orbits.emplace_back(0.5 + i * 0.01, 0.2 * (i % 8) / 8);
+            points.emplace_back(1.5 - i * 0.001, 0.8);
+        }
+        EllipseBatch<Decimal> batch{orbits};
+        std::vector<vec> projections(orbits.size());
+        benchmark.run("Ellipse::projection/scalar/1000", orbits.size(), [&] {
+            for (std::size_t i = 0; i < orbits.size(); i++)
+            {
+                projections[i] = orbits[i].projection(points[i]);
+            }
+            doNotOptimize(projections.data());
+        });
+        benchmark.run("EllipseBatch::projection/1000", orbits.size(), [&] {
+            batch.projection(points, projections);
+            doNotOptimize(projections.data());
+        });
+
+        std::vector<std::uint8_t> contained(orbits.size());
+        benchmark.run("Ellipse::contains/scalar/1000", orbits.size(), [&] {
+            for (std::size_t i = 0; i < orbits.size(); i++)
+            {
+                contained[i] = orbits[i].contains(rect);
+            }
+            doNotOptimize(contained.data());
+        });
+        benchmark.run("EllipseBatch::contains/1000", orbits.size(), [&] {
+            batch.contains(rect, contained);
+            doNotOptimize(contained.data());
+        });
+
+        Decimal a = 1;
+        Decimal b = -3;
+        Decimal c = 2;
+        benchmark.run("quadratic", 1, [&] {
+            doNotOptimize(a);
+            doNotOptimize(quadratic(a, b, c));
+        });
+
+        std::vector<Decimal> as(orbits.size(), a);
+        std::vector<Decimal> bs(orbits.size(), b);
+        std::vector<Decimal> cs(orbits.size(), c);
+        std::vector<Decimal> x0s(orbits.size());
+        std::vector<Decimal> x1s(orbits.size());
+        benchmark.run("quadraticBatch/1000", orbits.size(), [&] {
+            quadraticBatch<Decimal>(as, bs, cs, x0s, x1s, contained);
+            doNotOptimize(x0s.data());
+        });
+
+        // Earth to Mars like transfers, at a range of transfer angles and times of flight:
+        Decimal const mu = G() * 1.9884e30;
+        std::vector<vec> departures(orbits.size(), vec{au(1), 0});
+        std::vector<vec> arrivals;
+        std::vector<Decimal> tofs;
+        for (std::size_t i = 0; i < orbits.size(); i++)
+        {
+            arrivals.emplace_back(au(1.524) * std::cos(i * 0.006), au(1.524) * std::sin(i * 0.006));
+            tofs.push_back((60 + i * 0.6) * 24 * 60 * 60);
+        }
+        std::vector<vec> v1s(orbits.size());
+        std::vector<vec> v2s(orbits.size());
+        benchmark.run("lambert/scalar/1000", orbits.size(), [&] {
+            for (std::size_t i = 0; i < orbits.size(); i++)
+            {
+                v1s[i] = lambert(mu, departures[i], arrivals[i], tofs[i]).departure;
+            }
+            doNotOptimize(v1s.data());
+        });
+        benchmark.run("lambertBatch/1000", orbits.size(), [&] {
+            lambertBatch<Decimal>(mu, departures, arrivals, tofs, v1s, v2s);
+            doNotOptimize(v1s.data());
+        });
+    }
+
+    // Rendering:
+    {
+        Graphics graphics{35, 121};
+        Ellipse<Decimal> ellipse{au(1.5), 0.1};
+        graphics.scale(1 / au(1.6));
+        benchmark.run("Graphics::ellipse", 1, [&] {
+            graphics.clear();
+            graphics.ellipse(ellipse);
+        });
+
+        NullBuffer buffer;
+        std::ostream null{&buffer};
+        benchmark.run("Graphics::present", 1, [&] {
+            graphics.present(null);
+        });
+    }
+
+    if (output.empty())
+    {
+        benchmark.json(std::cout);
+    }
+    else
+    {
+        std::ofstream file{output};
+        benchmark.json(file);
+    }
+}
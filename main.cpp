@@ -1,12 +1,313 @@
+#include <filesystem>
 #include <iostream>
+#include <fstream>
 #include <iomanip>
+#include <random>
+#include <string_view>
 #include <thread>
+#include <sys/resource.h>
 #include <orbital/common/convert.h>
+#include <orbital/common/FrameScheduler.h>
+#include <orbital/common/parallel.h>
+#include <orbital/common/trace.h>
+#include "src/orbital/graphics/Canvas.h"
+#include "src/orbital/graphics/FrameWriter.h"
+#include "src/orbital/physical/Porkchop.h"
+#include "src/orbital/physical/Simulation.h"
 #include "src/orbital/physical/System.h"
 #include "src/orbital/graphics/Graphics.h"
 
+/**
+ * Command line options.
+ */
+struct Options
+{
+    bool threaded{false};
+    bool headless{false};
+    bool hud{false};                    ///<        Show metrics in the top row
+    std::string file{"planets.yml"};
+    std::string scenario{"solar-system"};
+    std::uint64_t steps{100000};        ///<        Steps to run in headless mode
+    Decimal dt{60 * 60};                ///< [s]    Simulated time per step
+    std::size_t threads{1};             ///<        Stepping threads, 0 for all hardware threads
+    std::size_t belt{0};                ///<        Count of synthetic asteroids to add
+    std::size_t density{1000};          ///<        Count of asteroids above which they are drawn as density map
+    std::uint64_t frames{10000000};     ///<        Frames to render in interactive modes
+    std::string trace;                  ///<        File to export traced zones to on exit
+    std::string framesOut;              ///<        Directory to write rendered frames to as images, if not empty
+    std::size_t frameWidth{1280};       ///< [px]   Size of written frames
+    std::size_t frameHeight{720};       ///< [px]
+    Integrator integrator{Integrator::Projection};
+    Decimal tolerance{NBody::defaultTolerance()};   ///< Error tolerance of adaptive integrators
+    std::uint64_t diagnostics{0};       ///<        Steps between logging the drift of invariants, 0 to not measure
+    std::uint64_t reorder{System::defaultReorderInterval()};  ///< Steps between checking the order of bodies, 0 never
+    std::string porkchop;               ///<        File to write a porkchop grid to, instead of simulating
+    std::string transfer{"Earth:Mars"}; ///<        Bodies of the porkchop grid, as departure:arrival
+    std::uint32_t grid{1000};           ///<        Count of departure and of arrival dates of the porkchop grid
+};
+
+/**
+ * Parse command line options.
+ * @throw std::runtime_error On unknown options or missing values.
+ * @throw std::logic_error On malformed numbers.
+ */
+Options
+parse(
+        int const argc,
+        char **const argv
+)
+{
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view const option{argv[i]};
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error{fmt::format("Missing value for {}", option)};
+            }
+            return argv[++i];
+        };
+
+        if ("--threaded"sv == option)
+        {
+            options.threaded = true;
+        }
+        else if ("--headless"sv == option)
+        {
+            options.headless = true;
+        }
+        else if ("--hud"sv == option)
+        {
+            options.hud = true;
+        }
+        else if ("--file"sv == option)
+        {
+            options.file = value();
+        }
+        else if ("--scenario"sv == option)
+        {
+            options.scenario = value();
+        }
+        else if ("--steps"sv == option)
+        {
+            options.steps = std::stoull(value());
+        }
+        else if ("--dt"sv == option)
+        {
+            options.dt = std::stod(value());
+        }
+        else if ("--threads"sv == option)
+        {
+            options.threads = std::stoul(value());
+        }
+        else if ("--belt"sv == option)
+        {
+            options.belt = std::stoul(value());
+        }
+        else if ("--density"sv == option)
+        {
+            options.density = std::stoul(value());
+        }
+        else if ("--frames"sv == option)
+        {
+            options.frames = std::stoull(value());
+        }
+        else if ("--frames-out"sv == option)
+        {
+            options.framesOut = value();
+        }
+        else if ("--size"sv == option)
+        {
+            auto const size = value();
+            auto const separator = size.find('x');
+            if (std::string::npos == separator)
+            {
+                throw std::runtime_error{fmt::format("Malformed size {}, expected <width>x<height>", size)};
+            }
+            options.frameWidth = std::stoul(size.substr(0, separator));
+            options.frameHeight = std::stoul(size.substr(separator + 1));
+        }
+        else if ("--trace"sv == option)
+        {
+            options.trace = value();
+        }
+        else if ("--integrator"sv == option)
+        {
+            options.integrator = integratorFromName(value());
+        }
+        else if ("--tolerance"sv == option)
+        {
+            options.tolerance = std::stod(value());
+        }
+        else if ("--diagnostics"sv == option)
+        {
+            options.diagnostics = std::stoull(value());
+        }
+        else if ("--reorder"sv == option)
+        {
+            options.reorder = std::stoull(value());
+        }
+        else if ("--porkchop"sv == option)
+        {
+            options.porkchop = value();
+        }
+        else if ("--transfer"sv == option)
+        {
+            options.transfer = value();
+        }
+        else if ("--grid"sv == option)
+        {
+            options.grid = std::stoul(value());
+        }
+        else
+        {
+            throw std::runtime_error{fmt::format("Unknown option {}", option)};
+        }
+    }
+    return options;
+}
+
+/**
+ * Add an asteroid belt between Mars and Jupiter, to scale a scenario up to production sizes.
+ * Uses a fixed seed, so runs are comparable.
+ * @param system System to add to.
+ * @param count Count of asteroids.
+ */
+void
+addBelt(
+        System &system,
+        std::size_t const count
+)
+{
+    std::mt19937_64 random{42};
+    std::uniform_real_distribution<Decimal> a{2.1, 3.3};
+    std::uniform_real_distribution<Decimal> e{0, 0.2};
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        system.add(Body{fmt::format("Asteroid {}", i), 1e15, 1e3, au(a(random)), e(random)});
+    }
+}
+
+/**
+ * Export traced zones, if requested.
+ * @param options Options holding the trace file.
+ */
+void
+writeTrace(
+        Options const &options
+)
+{
+    if (options.trace.empty())
+    {
+        return;
+    }
+    if (!Trace::enabled())
+    {
+        std::cerr << "Tracing is disabled, rebuild with -DORBITAL_TRACING=ON to record zones" << std::endl;
+    }
+    std::ofstream file{options.trace};
+    Trace::write(file);
+}
+
+/**
+ * Log the drift of energy and angular momentum to stderr, every count of steps given by the options.
+ * @param system System to log.
+ * @param options Options holding the count of steps.
+ */
+void
+logDrift(
+        System const &system,
+        Options const &options
+)
+{
+    if (0 == options.diagnostics || 0 != system.steps() % options.diagnostics)
+    {
+        return;
+    }
+    if (auto const drift = system.drift())
+    {
+        std::cerr << fmt::format("step {} time {:.6g} s energy drift {:.3e} angular momentum drift {:.3e}",
+                system.steps(), system.time(), drift->energy, drift->angularMomentum) << std::endl;
+    }
+}
+
+/**
+ * Step a system without rendering, and print throughput as a single line JSON record.
+ * @param system System to step.
+ * @param options Options used, echoed in the record.
+ */
+void
+benchmark(
+        System &system,
+        Options const &options
+)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    for (std::uint64_t step = 0; step < options.steps; step++)
+    {
+        system.stepSimulation();
+        logDrift(system, options);
+    }
+    auto const seconds = std::chrono::duration<Decimal>{std::chrono::steady_clock::now() - begin}.count();
+
+    // Central body does not move:
+    auto const bodySteps = static_cast<Decimal>(options.steps) * (system.size() - 1);
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    fmt::print("{{\"scenario\":\"{}\",\"bodies\":{},\"steps\":{},\"dt\":{},\"threads\":{},\"seconds\":{},"
+               "\"steps_per_second\":{},\"body_steps_per_second\":{},\"ns_per_body_step\":{},"
+               "\"peak_rss_kb\":{}}}\n",
+            options.scenario, system.size(), options.steps, options.dt, threadCount(system.size() - 1,
+                    System::minimumBodiesPerThread(), options.threads), seconds, options.steps / seconds,
+            bodySteps / seconds, seconds * 1e9 / bodySteps, usage.ru_maxrss);
+}
+
+/**
+ * Write the porkchop grid of the transfer given by the options, and print throughput as a single line JSON record.
+ * Departures span two years, arrivals span 60 days to three years after the first departure.
+ * @param system System to take bodies from.
+ * @param options Options holding the file, transfer and grid size.
+ * @throw std::runtime_error On malformed transfers, unknown bodies, or if writing fails.
+ */
+void
+writePorkchop(
+        System &system,
+        Options const &options
+)
+{
+    auto const separator = options.transfer.find(':');
+    if (std::string::npos == separator)
+    {
+        throw std::runtime_error{fmt::format("Malformed transfer {}, expected departure:arrival", options.transfer)};
+    }
+    Porkchop const porkchop{system, options.transfer.substr(0, separator), options.transfer.substr(separator + 1)};
+
+    Decimal const day = 24 * 60 * 60;
+    PorkchopGrid const grid{0, 730 * day / options.grid, options.grid, 60 * day, (1095 - 60) * day / options.grid,
+            options.grid};
+
+    auto const begin = std::chrono::steady_clock::now();
+    std::ofstream file{options.porkchop, std::ios::binary};
+    porkchop.write(grid, file, options.threads);
+    file.close();
+    auto const seconds = std::chrono::duration<Decimal>{std::chrono::steady_clock::now() - begin}.count();
+
+    auto const transfers = static_cast<Decimal>(grid.departures) * grid.arrivals;
+    fmt::print("{{\"transfer\":\"{}\",\"departures\":{},\"arrivals\":{},\"threads\":{},\"seconds\":{},"
+               "\"transfers_per_second\":{}}}\n",
+            options.transfer, grid.departures, grid.arrivals, threadCount(Porkchop::bandRows(),
+                    Porkchop::minimumRowsPerThread(), options.threads), seconds, transfers / seconds);
+}
+
 int
-main()
+main(
+        int argc,
+        char **argv
+)
 {
     /*Ellipse ellipse{2, 0.5};
     Graphics graphics{35};
@@ -18,42 +319,198 @@ main()
     graphics.border();
     graphics.present();*/
 
+    Options options;
+    try
+    {
+        options = parse(argc, argv);
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << e.what() << "\n"
+                  << "Usage: " << argv[0] << " [--headless | --threaded] [--file <archive>] [--scenario <name>]"
+                  << " [--steps <count>] [--dt <seconds>] [--threads <count>] [--belt <count>] [--density <count>]"
+                  << " [--frames <count>] [--frames-out <directory> [--size <width>x<height>]]"
+                  << " [--trace <file.json>] [--hud]"
+                  << " [--integrator projection|leapfrog|yoshida4|yoshida6|wisdom-holman|dormand-prince5"
+                  << "|dormand-prince853]"
+                  << " [--tolerance <relative>] [--diagnostics <steps>]"
+                  << " [--reorder <steps>]"
+                  << " [--porkchop <file> [--transfer <departure>:<arrival>] [--grid <count>]]" << std::endl;
+        return 1;
+    }
+
+    System system{options.file, options.scenario, options.dt};
+    system.threads(options.threads);
+    system.integrator(options.integrator);
+    system.tolerance(options.tolerance);
+    system.diagnostics(0 != options.diagnostics);
+    system.reorderInterval(options.reorder);
+    std::size_t const scenarioSize = system.size();
+    addBelt(system, options.belt);
+
+    // Evaluate transfers only, without simulating:
+    if (!options.porkchop.empty())
+    {
+        writePorkchop(system, options);
+        writeTrace(options);
+        return 0;
+    }
+
+    // Measure raw simulation throughput, without rendering or pacing:
+    if (options.headless)
+    {
+        benchmark(system, options);
+        writeTrace(options);
+        return 0;
+    }
+
     Graphics graphics{35, 121};
-    System system{"planets.yml", "solar-system", 60 * 60};
 
-    auto &earth = system.find("Mars");
+    // Bodies are never added while simulating, so they can be referenced by their snapshot index:
+    std::vector<Body const *> bodies;
+    system.foreach([&](Body &body) {
+        bodies.push_back(&body);
+    });
+    auto const mars = std::find_if(bodies.begin(), bodies.end(), [](Body const *body) {
+        return body->getName() == "Mars";
+    });
+    // Scenario without Mars, track the central body instead:
+    std::size_t const earth = bodies.end() == mars ? 0 : static_cast<std::size_t>(mars - bodies.begin());
+
+    // Orbits and labels of many asteroids would take long to draw and be illegible, so they are drawn as density map:
+    bool const dense = bodies.size() - scenarioSize > options.density;
+    std::size_t const labeled = dense ? scenarioSize : bodies.size();
 
-    for (int i = 0; i < 10000000; i++)
+    // Optionally, the same scene is painted onto a canvas and written to image files in the background:
+    std::optional<Canvas> canvas;
+    std::optional<FrameWriter> frameWriter;
+    if (!options.framesOut.empty())
     {
-        system.stepSimulation();
+        std::filesystem::create_directories(options.framesOut);
+        canvas.emplace(options.frameWidth, options.frameHeight);
+        frameWriter.emplace((std::filesystem::path{options.framesOut} / "frame-{:05}").string());
+    }
 
-        // Set graphics transform to track earth:
+    // Set the transform of a render target to track earth:
+    auto track = [&](
+            TransformStack &target,
+            Snapshot const &snapshot
+    ) {
+        target.resetTransform();
+        target.scale(1 / au(1.6));
+        target.translate(convert<Graphics::WorldVector>(-snapshot.positions[earth]));
+    };
+
+    auto paint = [&](Snapshot const &snapshot) {
+        TRACE_ZONE("canvas");
+        track(*canvas, snapshot);
+        canvas->clear();
+
+        canvas->color({96, 96, 96});
+        canvas->points({snapshot.positions.data() + labeled, snapshot.positions.size() - labeled});
+        for (std::size_t index = 0; index < labeled; index++)
         {
-            graphics.resetTransform();
-            //graphics.rotate(0.5_pi);
-            graphics.scale(1 / au(1.6));
-            graphics.translate(convert<Graphics::WorldVector>(-earth.getPosition()));
+            Body const &body = *bodies[index];
+            canvas->push();
+            canvas->translate(convert<Canvas::WorldVector>(body.getTrajectory().focalPoints()[0]));
+            canvas->color({64, 128, 255});
+            canvas->ellipse(body.getTrajectory());
+            canvas->pop();
+            canvas->color({255, 255, 255});
+            canvas->point(convert<Canvas::WorldVector>(snapshot.positions[index]));
         }
+        frameWriter->write(*canvas);
+    };
+
+    auto render = [&](Snapshot const &snapshot) {
+
+        // Set graphics transform to track earth:
+        track(graphics, snapshot);
 
         // Render:
         graphics.clear();
 
+        if (dense)
+        {
+            graphics.density({snapshot.positions.data() + labeled, snapshot.positions.size() - labeled},
+                    Graphics::DensityScale::Logarithmic);
+        }
+
         // Paint body names:
-        system.foreach([&](Body &body) {
+        {
+            TRACE_ZONE("labels");
+            for (std::size_t index = 0; index < labeled; index++)
+            {
+                Body const &body = *bodies[index];
 
-            graphics.push();
-            graphics.translate(convert<Graphics::WorldVector>(body.getTrajectory().focalPoints()[0]));
-            graphics.overwrite(false);
-            graphics.ellipse(body.getTrajectory());
-            graphics.overwrite(true);
-            graphics.pop();
+                graphics.push();
+                graphics.translate(convert<Graphics::WorldVector>(body.getTrajectory().focalPoints()[0]));
+                graphics.overwrite(false);
+                graphics.ellipse(body.getTrajectory());
+                graphics.overwrite(true);
+                graphics.pop();
 
-            graphics.label(convert<Graphics::WorldVector>(body.getPosition()), body.getName());
-        });
+                graphics.label(convert<Graphics::WorldVector>(snapshot.positions[index]), body.getName());
+            }
+        }
 
         graphics.border();
+        if (options.hud)
+        {
+            graphics.hud(system.metrics().format() + " " + graphics.metrics().format());
+        }
         graphics.present();
 
-        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        if (canvas)
+        {
+            paint(snapshot);
+        }
+    };
+
+    // Run the simulation on its own thread as fast as possible, instead of pacing it to the display:
+    if (options.threaded)
+    {
+        // Simulation runs on its own thread, rendering picks up the latest state at its own cadence:
+        Simulation simulation{system};
+        simulation.start();
+
+        for (std::uint64_t i = 0; i < options.frames; i++)
+        {
+            TRACE_ZONE("frame");
+            render(simulation.latest());
+            std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        }
+        simulation.stop();
+        writeTrace(options);
+        return 0;
+    }
+
+    // Simulate 20 hours per second at 20 frames per second:
+    FrameScheduler scheduler{20, 20 * 60 * 60, system.dt()};
+    Snapshot snapshot;
+
+    for (std::uint64_t i = 0; i < options.frames; i++)
+    {
+        TRACE_ZONE("frame");
+        auto const steps = scheduler.beginFrame();
+
+        auto const stepBegin = FrameScheduler::Clock::now();
+        for (std::size_t step = 0; step < steps; step++)
+        {
+            system.stepSimulation();
+            logDrift(system, options);
+        }
+        auto const stepEnd = FrameScheduler::Clock::now();
+        scheduler.stepped(steps, stepEnd - stepBegin);
+
+        if (scheduler.shouldRender(stepEnd))
+        {
+            system.snapshot(snapshot);
+            render(snapshot);
+            scheduler.rendered(FrameScheduler::Clock::now() - stepEnd);
+        }
+
+        scheduler.endFrame();
     }
+    writeTrace(options);
 }
@@ -4,74 +4,250 @@
 
 #pragma once
 
-#include <array>
 #include <cassert>
+#include <initializer_list>
+#include <new>
 #include <ostream>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Uninitialized storage for up to N elements, and the count of constructed ones.
+ * Destroys the constructed elements, unless they are trivially destructible, in which case the storage is trivially
+ * destructible too.
+ */
+template<class T, std::size_t N, bool = std::is_trivially_destructible_v<T>>
+class DynamicArrayStorage
+{
+
+protected:
+
+    constexpr DynamicArrayStorage()
+            : mEmpty{}
+    {
+    }
+
+    union
+    {
+        char mEmpty;        ///< Active member while no element was constructed, so construction does not touch mValues
+        T mValues[N];
+    };
+    std::size_t mLength{0};
+
+};
+
+template<class T, std::size_t N>
+class DynamicArrayStorage<T, N, false>
+{
+
+protected:
+
+    constexpr DynamicArrayStorage()
+            : mEmpty{}
+    {
+    }
+
+    ~DynamicArrayStorage()
+    {
+        for (std::size_t i = 0; i < mLength; i++)
+        {
+            mValues[i].~T();
+        }
+    }
+
+    union
+    {
+        char mEmpty;        ///< Active member while no element was constructed, so construction does not touch mValues
+        T mValues[N];
+    };
+    std::size_t mLength{0};
+
+};
+
+/**
+ * Copies and moves the constructed elements of a `DynamicArrayStorage`. For trivially copyable elements, copies and
+ * moves are defaulted instead, so the storage is trivially copyable too, and copied as a whole.
+ */
+template<class T, std::size_t N, bool = std::is_trivially_copyable_v<T>>
+class DynamicArrayCopy
+        : protected DynamicArrayStorage<T, N>
+{
+
+protected:
+
+    using DynamicArrayStorage<T, N>::mValues;
+    using DynamicArrayStorage<T, N>::mLength;
+
+    constexpr DynamicArrayCopy() = default;
+
+    DynamicArrayCopy(
+            DynamicArrayCopy const &other
+    )
+    {
+        append(other);
+    }
+
+    DynamicArrayCopy(
+            DynamicArrayCopy &&other
+    ) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        append(std::move(other));
+    }
+
+    DynamicArrayCopy &
+    operator=(
+            DynamicArrayCopy const &other
+    )
+    {
+        if (this != &other)
+        {
+            destroy();
+            append(other);
+        }
+        return *this;
+    }
+
+    DynamicArrayCopy &
+    operator=(
+            DynamicArrayCopy &&other
+    ) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other)
+        {
+            destroy();
+            append(std::move(other));
+        }
+        return *this;
+    }
+
+    ~DynamicArrayCopy() = default;
+
+private:
+
+    /**
+     * Construct copies of the elements of another array behind the last one, or move them if it is an rvalue.
+     */
+    template<class TOther>
+    void
+    append(
+            TOther &&other
+    )
+    {
+        for (std::size_t i = 0; i < other.mLength; i++)
+        {
+            if constexpr (std::is_lvalue_reference_v<TOther>)
+            {
+                new(mValues + mLength) T(other.mValues[i]);
+            }
+            else
+            {
+                new(mValues + mLength) T(std::move(other.mValues[i]));
+            }
+            ++mLength;
+        }
+    }
+
+    void
+    destroy()
+    {
+        while (mLength > 0)
+        {
+            --mLength;
+            mValues[mLength].~T();
+        }
+    }
+
+};
+
+template<class T, std::size_t N>
+class DynamicArrayCopy<T, N, true>
+        : protected DynamicArrayStorage<T, N>
+{
+};
 
 /**
  * A fixed-maximum sized array, with a dynamic count of actual values.
  * Efficient when maximum number of elements is known at compile-time, such a quadratic formula solutions.
  *
- * Elements must be default constructable and assignable.
+ * Elements are constructed in place within uninitialized storage when appended, so neither creating an array nor
+ * appending to it default constructs or assigns elements. Arrays of trivially destructible or trivially copyable
+ * elements are trivially destructible or trivially copyable too.
  *
- * Therefore, this class is only efficient for lightweight structures, but it optimizes the heap away, since everything
- * is stored directly on the stack.
+ * This optimizes the heap away, since everything is stored directly on the stack. See `SmallVector` for an array
+ * spilling to the heap instead of throwing when it overflows.
+ *
+ * @attention Since C++17 forbids changing the active member of a union during constant evaluation, only empty arrays
+ * can be used in constant expressions.
  */
-
 template<class T, std::size_t N>
 class DynamicArray
+        : private DynamicArrayCopy<T, N>
 {
 
+    static_assert(N > 0, "Dynamic array must have at least one value");
+
+    using DynamicArrayCopy<T, N>::mValues;
+    using DynamicArrayCopy<T, N>::mLength;
+
 public:
 
     /**
      * Create an empty array.
      */
-    constexpr DynamicArray()
-    {
-        static_assert(N > 0, "Dynamic array must have at least one value");
-    }
+    constexpr DynamicArray() = default;
 
     /**
      * Create an array with pre-initialized content.
      * @param il Initializing elements. Can be less than needed.
+     * @throw If the initializer list exceeds the maximum element count.
      */
-    constexpr DynamicArray(
+    DynamicArray(
             std::initializer_list<T> const &il
     )
-            : DynamicArray{}
     {
         if (il.size() > N)
         {
             throw std::runtime_error{"Initializer list is too long for dynamic array"};
         }
-        for (const auto e : il)
+        for (auto const &e : il)
         {
-            mArray[mLength] = std::move(e);
-            ++mLength;
+            construct(e);
         }
     }
 
+    DynamicArray(
+            DynamicArray const &
+    ) = default;
+
+    DynamicArray(
+            DynamicArray &&
+    ) = default;
+
+    DynamicArray &
+    operator=(
+            DynamicArray const &
+    ) = default;
+
+    DynamicArray &
+    operator=(
+            DynamicArray &&
+    ) = default;
+
+    ~DynamicArray() = default;
+
     /**
      * Append one element.
      * @param value Value to append.
      * @return Reference to appended element.
      * @throw If maximum element count is about to be exceeded.
      */
-    constexpr T &
+    T &
     push_back(
-            T const value
+            T const &value
     )
     {
-        if (mLength >= N)
-        {
-            throw std::runtime_error{"Exceeding maximum dynamic array size"};
-        }
-
-        mArray[mLength] = value;
-        ++mLength;
-        return mArray[mLength - 1];
+        return emplace_back(value);
     }
 
     /**
@@ -81,7 +257,7 @@ public:
      * @throw If maximum element count is about to be exceeded.
      */
     template<class... TArgs>
-    constexpr T &
+    T &
     emplace_back(
             TArgs &&...args
     )
@@ -90,10 +266,31 @@ public:
         {
             throw std::runtime_error{"Exceeding maximum dynamic array size"};
         }
+        return construct(std::forward<TArgs>(args)...);
+    }
 
-        mArray[mLength] = T{std::forward<TArgs>(args)...};
-        ++mLength;
-        return mArray[mLength - 1];
+    /**
+     * Remove the last element.
+     * @attention Do not call this if array is empty.
+     */
+    void
+    pop_back()
+    {
+        assert(mLength > 0);
+        --mLength;
+        mValues[mLength].~T();
+    }
+
+    /**
+     * Remove all elements.
+     */
+    void
+    clear()
+    {
+        while (mLength > 0)
+        {
+            pop_back();
+        }
     }
 
     /**
@@ -104,7 +301,7 @@ public:
     constexpr T &
     front()
     {
-        return mArray.front();
+        return mValues[0];
     }
 
     /**
@@ -115,25 +312,34 @@ public:
     constexpr T &
     back()
     {
-        return mArray[mLength - 1];
+        return mValues[mLength - 1];
+    }
+
+    /**
+     * @return Pointer to the first element.
+     */
+    constexpr T *
+    data()
+    {
+        return mValues;
     }
 
     /**
      * @return Begin iterator.
      */
-    constexpr auto
+    constexpr T *
     begin()
     {
-        return mArray.begin();
+        return mValues;
     }
 
     /**
      * @return End iterator.
      */
-    constexpr auto
+    constexpr T *
     end()
     {
-        return mArray.begin() + mLength;
+        return mValues + mLength;
     }
 
 #pragma clang diagnostic push
@@ -147,7 +353,7 @@ public:
     constexpr T const &
     front() const
     {
-        return mArray.front();
+        return mValues[0];
     }
 
     /**
@@ -158,25 +364,34 @@ public:
     constexpr T const &
     back() const
     {
-        return mArray[mLength - 1];
+        return mValues[mLength - 1];
+    }
+
+    /**
+     * @return Constant pointer to the first element.
+     */
+    constexpr T const *
+    data() const
+    {
+        return mValues;
     }
 
     /**
      * @return Constant begin iterator.
      */
-    constexpr auto const
+    constexpr T const *
     begin() const
     {
-        return mArray.begin();
+        return mValues;
     }
 
     /**
      * @return Constant end iterator.
      */
-    constexpr auto const
+    constexpr T const *
     end() const
     {
-        return mArray.begin() + mLength;
+        return mValues + mLength;
     }
 
 #pragma clang diagnostic pop
@@ -205,7 +420,7 @@ public:
     /**
      * Give a reference to an element by index.
      * @attention No bounds checking is performed, accessing elements beyond current array size returns
-     * initialized memory.
+     * uninitialized memory.
      * @param index Index denoting element to return.
      * @return Element reference.
      */
@@ -214,13 +429,13 @@ public:
             std::size_t const index
     )
     {
-        return mArray[index];
+        return mValues[index];
     }
 
     /**
      * Give a constant reference to an element by index.
      * @attention No bounds checking is performed, accessing elements beyond current array size returns
-     * initialized memory.
+     * uninitialized memory.
      * @param index Index denoting element to return.
      * @return Element reference.
      */
@@ -229,7 +444,7 @@ public:
             std::size_t const index
     ) const
     {
-        return mArray[index];
+        return mValues[index];
     }
 
     /**
@@ -255,27 +470,47 @@ public:
     }
 
     /**
-     * Size or shrunk the length of active elements directly.
-     * @param size New array size.
+     * Shrink the array by destroying trailing elements, or grow it by appending value initialized elements.
+     * @param size New array size, must not exceed the capacity.
      */
-    constexpr void
+    void
     resize(
             size_t const size
     )
     {
         assert(size <= N);
-        mLength = size;
+        while (mLength > size)
+        {
+            pop_back();
+        }
+        while (mLength < size)
+        {
+            construct();
+        }
     }
 
-    constexpr bool const
-    empty()
+    constexpr bool
+    empty() const
     {
         return 0 == mLength;
     }
 
 private:
 
-    std::size_t mLength{0};
-    std::array<T, N> mArray;
+    /**
+     * Construct an element behind the last one, without checking the capacity.
+     * @param args Arguments passed to constructor.
+     * @return Constructed element.
+     */
+    template<class... TArgs>
+    T &
+    construct(
+            TArgs &&...args
+    )
+    {
+        T *const element = new(mValues + mLength) T{std::forward<TArgs>(args)...};
+        ++mLength;
+        return *element;
+    }
 
 };
@@ -0,0 +1,171 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include "FrameScheduler.h"
+
+namespace
+{
+
+Decimal
+seconds(
+        FrameScheduler::Clock::duration const duration
+)
+{
+    return std::chrono::duration<Decimal>{duration}.count();
+}
+
+Decimal
+average(
+        Decimal const mean,
+        Decimal const sample
+)
+{
+    // First sample initializes the average:
+    return 0 == mean ? sample : mean + FrameScheduler::smoothing() * (sample - mean);
+}
+
+/**
+ * Validate the parameters of a scheduler, before any of them is used.
+ * @param framesPerSecond [1/s] Target frame rate.
+ * @param warp Simulated seconds per wall second.
+ * @param dt [s] Simulated time per step.
+ * @return Wall time per frame.
+ */
+FrameScheduler::Clock::duration
+interval(
+        Decimal const framesPerSecond,
+        Decimal const warp,
+        Decimal const dt
+)
+{
+    // Negated, so NaN is rejected as well:
+    if (!(framesPerSecond > 0 && warp >= 0 && dt > 0))
+    {
+        throw std::runtime_error{"Frame rate and step size must be positive, warp must not be negative"};
+    }
+    return std::chrono::duration_cast<FrameScheduler::Clock::duration>(std::chrono::duration<Decimal>{
+            1 / framesPerSecond});
+}
+
+}
+
+FrameScheduler::FrameScheduler(
+        Decimal const framesPerSecond,
+        Decimal const warp,
+        Decimal const dt,
+        std::size_t const maxDroppedFrames
+)
+        : mInterval{interval(framesPerSecond, warp, dt)}
+        , mStepsPerSecond{warp / dt}
+        , mMaxDroppedFrames{maxDroppedFrames}
+{
+}
+
+std::size_t
+FrameScheduler::beginFrame(
+        Clock::time_point const now
+)
+{
+    if (mStarted)
+    {
+        mOwed += mStepsPerSecond * seconds(now - mLastBegin);
+
+        // Keep a fixed cadence, but do not try to catch up on frames missed entirely:
+        mDeadline += mInterval;
+        if (mDeadline <= now)
+        {
+            mDeadline = now + mInterval;
+        }
+    }
+    else
+    {
+        mOwed = mStepsPerSecond * seconds(mInterval);
+        mDeadline = now + mInterval;
+        mStarted = true;
+    }
+    mLastBegin = now;
+
+    auto steps = std::floor(mOwed);
+    if (mStepCost > 0)
+    {
+        // More steps than fit into a whole frame can never be caught up on, so drop that backlog:
+        auto const capacity = std::max<Decimal>(1, std::floor(seconds(mInterval) / mStepCost));
+        steps = std::min(steps, capacity);
+        mOwed = std::min(mOwed - steps, capacity);
+    }
+    else
+    {
+        mOwed -= steps;
+    }
+    return static_cast<std::size_t>(steps);
+}
+
+void
+FrameScheduler::stepped(
+        std::size_t const steps,
+        Clock::duration const elapsed
+)
+{
+    if (steps > 0)
+    {
+        mStepCost = average(mStepCost, seconds(elapsed) / steps);
+    }
+}
+
+bool
+FrameScheduler::shouldRender(
+        Clock::time_point const now
+)
+{
+    if (seconds(mDeadline - now) >= mRenderCost || mDroppedInRow >= mMaxDroppedFrames)
+    {
+        mDroppedInRow = 0;
+        return true;
+    }
+    mDroppedInRow++;
+    mDroppedFrames++;
+    return false;
+}
+
+void
+FrameScheduler::rendered(
+        Clock::duration const elapsed
+)
+{
+    mRenderCost = average(mRenderCost, seconds(elapsed));
+}
+
+void
+FrameScheduler::endFrame() const
+{
+    std::this_thread::sleep_until(mDeadline);
+}
+
+FrameScheduler::Clock::time_point
+FrameScheduler::deadline() const
+{
+    return mDeadline;
+}
+
+Decimal
+FrameScheduler::stepCost() const
+{
+    return mStepCost;
+}
+
+Decimal
+FrameScheduler::renderCost() const
+{
+    return mRenderCost;
+}
+
+std::size_t
+FrameScheduler::droppedFrames() const
+{
+    return mDroppedFrames;
+}
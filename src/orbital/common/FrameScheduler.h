@@ -0,0 +1,149 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include "common.h"
+
+/**
+ * Paces a single threaded simulate-and-render loop, so that simulated time advances at a fixed rate relative to wall
+ * time, independently of how fast rendering happens to be.
+ *
+ * Each frame, the scheduler hands out the count of simulation steps owed for the wall time elapsed since the previous
+ * frame. After stepping, it decides whether there is still time left to render before the frame deadline. When the host
+ * is overloaded, rendering is dropped first, so the time warp stays predictable. Only if the steps alone exceed a whole
+ * frame budget, the backlog is discarded and simulated time falls behind.
+ *
+ * Usage:
+ * @code
+ * while (true)
+ * {
+ *     auto const steps = scheduler.beginFrame();
+ *     // ...run steps, then call scheduler.stepped()...
+ *     if (scheduler.shouldRender())
+ *     {
+ *         // ...render, then call scheduler.rendered()...
+ *     }
+ *     scheduler.endFrame();
+ * }
+ * @endcode
+ */
+class FrameScheduler
+{
+
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Create a scheduler.
+     * @param framesPerSecond [1/s] Target frame rate.
+     * @param warp Simulated time per wall time, e.g. 86400 to simulate a day per second.
+     * @param dt [s] Simulated time per step.
+     * @param maxDroppedFrames Count of frames that may be dropped in a row before rendering is forced, to keep the
+     * display from freezing under permanent overload.
+     */
+    FrameScheduler(
+            Decimal framesPerSecond,
+            Decimal warp,
+            Decimal dt,
+            std::size_t maxDroppedFrames = 10
+    );
+
+    /**
+     * Start a new frame.
+     * @param now Current time.
+     * @return Count of simulation steps to run in this frame.
+     */
+    std::size_t
+    beginFrame(
+            Clock::time_point now = Clock::now()
+    );
+
+    /**
+     * Report the time spent stepping, used to estimate step cost.
+     * @param steps Count of steps run.
+     * @param elapsed Wall time spent on them.
+     */
+    void
+    stepped(
+            std::size_t steps,
+            Clock::duration elapsed
+    );
+
+    /**
+     * Decide whether the current frame should be rendered. Counts the frame as dropped if not.
+     * @param now Current time.
+     * @return True if rendering is expected to finish before the frame deadline, or too many frames were dropped.
+     */
+    bool
+    shouldRender(
+            Clock::time_point now = Clock::now()
+    );
+
+    /**
+     * Report the time spent rendering, used to estimate render cost.
+     * @param elapsed Wall time spent on rendering.
+     */
+    void
+    rendered(
+            Clock::duration elapsed
+    );
+
+    /**
+     * Sleep until the current frame's deadline.
+     */
+    void
+    endFrame() const;
+
+    /**
+     * @return End of the current frame.
+     */
+    Clock::time_point
+    deadline() const;
+
+    /**
+     * @return [s] Estimated wall time per simulation step. 0 until the first steps were reported.
+     */
+    Decimal
+    stepCost() const;
+
+    /**
+     * @return [s] Estimated wall time per rendered frame. 0 until the first frame was rendered.
+     */
+    Decimal
+    renderCost() const;
+
+    /**
+     * @return Count of frames not rendered since creation.
+     */
+    std::size_t
+    droppedFrames() const;
+
+    /**
+     * @return Weight of the newest sample in the moving step and render cost averages.
+     */
+    static constexpr Decimal
+    smoothing()
+    {
+        return 0.125;
+    }
+
+private:
+
+    Clock::duration mInterval;          ///<        Wall time per frame
+    Decimal mStepsPerSecond;            ///< [1/s]  Steps owed per wall second
+    std::size_t mMaxDroppedFrames;
+    bool mStarted{false};
+    Clock::time_point mLastBegin;
+    Clock::time_point mDeadline;
+    Decimal mOwed{0};                   ///<        Steps owed, including fractions carried over from earlier frames
+    Decimal mStepCost{0};               ///< [s]    Moving average of wall time per step
+    Decimal mRenderCost{0};             ///< [s]    Moving average of wall time per render
+    std::size_t mDroppedInRow{0};
+    std::size_t mDroppedFrames{0};
+
+};
@@ -0,0 +1,101 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "fmt/format.h"
+#include "Metrics.h"
+
+std::uint64_t
+Counter::value() const
+{
+    std::uint64_t sum = 0;
+    for (auto const &shard : mShards)
+    {
+        sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void
+Counter::reset()
+{
+    for (auto &shard : mShards)
+    {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t
+Counter::shard()
+{
+    // Threads are assigned shards round robin when they first increment any counter:
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t const index = next.fetch_add(1, std::memory_order_relaxed) % shards();
+    return index;
+}
+
+Counter &
+Metrics::counter(
+        std::string_view const name
+)
+{
+    auto iter = std::find_if(mCounters.begin(), mCounters.end(), [&](auto const &entry) {
+        return entry.first == name;
+    });
+    if (mCounters.end() != iter)
+    {
+        return iter->second;
+    }
+
+    mCounters.emplace_back(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple());
+    return mCounters.back().second;
+}
+
+std::uint64_t
+Metrics::value(
+        std::string_view const name
+) const
+{
+    auto iter = std::find_if(mCounters.begin(), mCounters.end(), [&](auto const &entry) {
+        return entry.first == name;
+    });
+    if (mCounters.end() == iter)
+    {
+        throw std::runtime_error{fmt::format("No such counter: {}", name)};
+    }
+    return iter->second.value();
+}
+
+std::vector<std::pair<std::string, std::uint64_t>>
+Metrics::read() const
+{
+    std::vector<std::pair<std::string, std::uint64_t>> result;
+    result.reserve(mCounters.size());
+    for (auto const &[name, counter] : mCounters)
+    {
+        result.emplace_back(name, counter.value());
+    }
+    return result;
+}
+
+void
+Metrics::reset()
+{
+    for (auto &[name, counter] : mCounters)
+    {
+        counter.reset();
+    }
+}
+
+std::string
+Metrics::format() const
+{
+    std::string result;
+    for (auto const &[name, value] : read())
+    {
+        result += fmt::format("{}{}={}", result.empty() ? "" : " ", name, value);
+    }
+    return result;
+}
@@ -0,0 +1,145 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Monotonic event counter, cheap to increment from many threads at once.
+ *
+ * The count is split into shards on separate cache lines, and each thread increments its own shard, so concurrent
+ * increments do not contend. Shards are summed up on read.
+ */
+class Counter
+{
+
+public:
+
+    Counter() = default;
+
+    Counter(Counter const &) = delete;
+
+    Counter &
+    operator=(Counter const &) = delete;
+
+    /**
+     * Increment the calling thread's shard.
+     * @param count Amount to add.
+     */
+    void
+    add(
+            std::uint64_t const count = 1
+    )
+    {
+        mShards[shard()].value.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return Sum of all shards. Concurrent increments may or may not be included.
+     */
+    std::uint64_t
+    value() const;
+
+    /**
+     * Set all shards to 0.
+     */
+    void
+    reset();
+
+    /**
+     * @return Count of shards. Threads beyond this count share shards, which is still correct, just slower.
+     */
+    static constexpr std::size_t
+    shards()
+    {
+        return shardCount;
+    }
+
+private:
+
+    static constexpr std::size_t shardCount = 16;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::array<Shard, shardCount> mShards;
+
+    /**
+     * @return Shard index of the calling thread.
+     */
+    static std::size_t
+    shard();
+
+};
+
+/**
+ * Registry of named counters, e.g. exposed by a component to surface what it is doing.
+ */
+class Metrics
+{
+
+public:
+
+    Metrics() = default;
+
+    Metrics(Metrics const &) = delete;
+
+    Metrics &
+    operator=(Metrics const &) = delete;
+
+    /**
+     * Give a counter by name, creating it on first use.
+     * Registering is not thread safe, so counters should be registered up front, before incrementing concurrently.
+     * @param name Counter name.
+     * @return Counter, stays valid for the lifetime of the registry.
+     */
+    Counter &
+    counter(
+            std::string_view name
+    );
+
+    /**
+     * Read the value of a counter.
+     * @param name Counter name.
+     * @return Counter value.
+     * @throw std::runtime_error If no such counter is registered.
+     */
+    std::uint64_t
+    value(
+            std::string_view name
+    ) const;
+
+    /**
+     * @return All counter names and values, in order of registration.
+     */
+    std::vector<std::pair<std::string, std::uint64_t>>
+    read() const;
+
+    /**
+     * Set all counters to 0.
+     */
+    void
+    reset();
+
+    /**
+     * @return All counters as a single line: `name=value name=value ...`
+     */
+    std::string
+    format() const;
+
+private:
+
+    std::deque<std::pair<std::string, Counter>> mCounters;
+
+};
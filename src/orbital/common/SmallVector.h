@@ -0,0 +1,264 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "DynamicArray.h"
+
+/**
+ * A vector storing up to N elements inline, like `DynamicArray`, but moving them to the heap instead of throwing when
+ * more are appended.
+ *
+ * Use this where a small count of elements is typical, but no compile-time maximum exists, e.g. intersections with
+ * an arbitrary polygon. As long as the count stays within N, no memory is allocated.
+ *
+ * @attention Appending may move all elements, which invalidates references, pointers and iterators to them.
+ */
+template<class T, std::size_t N>
+class SmallVector
+{
+
+public:
+
+    /**
+     * Create an empty vector.
+     */
+    SmallVector() = default;
+
+    /**
+     * Create a vector with pre-initialized content.
+     * @param il Initializing elements, may exceed N.
+     */
+    SmallVector(
+            std::initializer_list<T> const &il
+    )
+    {
+        reserve(il.size());
+        for (auto const &e : il)
+        {
+            push_back(e);
+        }
+    }
+
+    /**
+     * Append one element.
+     * @param value Value to append.
+     * @return Reference to appended element.
+     */
+    T &
+    push_back(
+            T const &value
+    )
+    {
+        return emplace_back(value);
+    }
+
+    /**
+     * Construct a new element in-place.
+     * @param args Arguments passed to constructor.
+     * @return Reference to appended element.
+     */
+    template<class... TArgs>
+    T &
+    emplace_back(
+            TArgs &&...args
+    )
+    {
+        if (!mSpilled && mInline.size() == N)
+        {
+            // Arguments may refer to inline elements, which are moved away by spilling, so construct first:
+            T element{std::forward<TArgs>(args)...};
+            reserve(2 * N);
+            return mHeap.emplace_back(std::move(element));
+        }
+        if (mSpilled)
+        {
+            return mHeap.emplace_back(T{std::forward<TArgs>(args)...});
+        }
+        return mInline.emplace_back(std::forward<TArgs>(args)...);
+    }
+
+    /**
+     * Remove the last element.
+     * @attention Do not call this if vector is empty.
+     */
+    void
+    pop_back()
+    {
+        mSpilled ? mHeap.pop_back() : mInline.pop_back();
+    }
+
+    /**
+     * Remove all elements. Memory already allocated is kept.
+     */
+    void
+    clear()
+    {
+        mInline.clear();
+        mHeap.clear();
+    }
+
+    /**
+     * Make room for a count of elements. Moves the elements to the heap, if the count exceeds N.
+     * @param count Count of elements.
+     */
+    void
+    reserve(
+            std::size_t const count
+    )
+    {
+        if (count <= N && !mSpilled)
+        {
+            return;
+        }
+        if (!mSpilled)
+        {
+            mHeap.reserve(count);
+            for (auto &e : mInline)
+            {
+                mHeap.push_back(std::move(e));
+            }
+            mInline.clear();
+            mSpilled = true;
+        }
+        mHeap.reserve(count);
+    }
+
+    /**
+     * @return True, if the elements moved to the heap.
+     */
+    bool
+    spilled() const
+    {
+        return mSpilled;
+    }
+
+    /**
+     * @return Current count of elements.
+     */
+    std::size_t
+    size() const
+    {
+        return mSpilled ? mHeap.size() : mInline.size();
+    }
+
+    bool
+    empty() const
+    {
+        return 0 == size();
+    }
+
+    /**
+     * @return Pointer to the first element.
+     */
+    T *
+    data()
+    {
+        return mSpilled ? mHeap.data() : mInline.data();
+    }
+
+    /**
+     * @return Constant pointer to the first element.
+     */
+    T const *
+    data() const
+    {
+        return mSpilled ? mHeap.data() : mInline.data();
+    }
+
+    /**
+     * @return Begin iterator.
+     */
+    T *
+    begin()
+    {
+        return data();
+    }
+
+    /**
+     * @return End iterator.
+     */
+    T *
+    end()
+    {
+        return data() + size();
+    }
+
+    /**
+     * @return Constant begin iterator.
+     */
+    T const *
+    begin() const
+    {
+        return data();
+    }
+
+    /**
+     * @return Constant end iterator.
+     */
+    T const *
+    end() const
+    {
+        return data() + size();
+    }
+
+    /**
+     * Give reference to first element.
+     * @attention Do not call this if vector is empty.
+     * @return First element.
+     */
+    T &
+    front()
+    {
+        return *begin();
+    }
+
+    /**
+     * Give reference to last element.
+     * @attention Do not call this if vector is empty.
+     * @return Last element.
+     */
+    T &
+    back()
+    {
+        return *(end() - 1);
+    }
+
+    /**
+     * Give a reference to an element by index.
+     * @attention No bounds checking is performed.
+     * @param index Index denoting element to return.
+     * @return Element reference.
+     */
+    T &
+    operator[](
+            std::size_t const index
+    )
+    {
+        return data()[index];
+    }
+
+    /**
+     * Give a constant reference to an element by index.
+     * @attention No bounds checking is performed.
+     * @param index Index denoting element to return.
+     * @return Element reference.
+     */
+    T const &
+    operator[](
+            std::size_t const index
+    ) const
+    {
+        return data()[index];
+    }
+
+private:
+
+    DynamicArray<T, N> mInline;     ///< Elements, while not spilled
+    std::vector<T> mHeap;           ///< Elements, once spilled
+    bool mSpilled{false};
+
+};
@@ -0,0 +1,139 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * A non-owning view over a contiguous sequence of elements, similar to C++20's `std::span`.
+ * Used to pass whole arrays into batch operations without copying them and without binding the callee to a specific
+ * container type.
+ *
+ * @attention The span does not extend the lifetime of the viewed elements.
+ */
+template<class T>
+class Span
+{
+
+public:
+
+    /**
+     * Create an empty span.
+     */
+    constexpr Span() = default;
+
+    /**
+     * Create a span over a raw array.
+     * @param data Pointer to first element.
+     * @param size Count of elements.
+     */
+    constexpr Span(
+            T *data,
+            std::size_t const size
+    )
+            : mData{data}
+            , mSize{size}
+    {
+    }
+
+    /**
+     * Create a span over any contiguous container providing `data()` and `size()`, e.g. `std::vector` or `std::array`.
+     * Constant and temporary containers can only be viewed by spans of constant elements.
+     * @param container Container to view.
+     */
+    template<class TContainer, class = std::enable_if_t<
+            std::is_convertible_v<decltype(std::declval<TContainer &>().data()), T *> &&
+                    (std::is_lvalue_reference_v<TContainer> || std::is_const_v<T>)>>
+    constexpr Span(
+            TContainer &&container
+    )
+            : Span{container.data(), container.size()}
+    {
+    }
+
+    /**
+     * @return Pointer to first element.
+     */
+    constexpr T *
+    data() const
+    {
+        return mData;
+    }
+
+    /**
+     * @return Count of viewed elements.
+     */
+    constexpr std::size_t
+    size() const
+    {
+        return mSize;
+    }
+
+    /**
+     * @return True if no elements are viewed.
+     */
+    constexpr bool
+    empty() const
+    {
+        return 0 == mSize;
+    }
+
+    /**
+     * @return Begin iterator.
+     */
+    constexpr T *
+    begin() const
+    {
+        return mData;
+    }
+
+    /**
+     * @return End iterator.
+     */
+    constexpr T *
+    end() const
+    {
+        return mData + mSize;
+    }
+
+    /**
+     * Give a reference to an element by index.
+     * @attention No bounds checking is performed.
+     * @param index Index denoting element to return.
+     * @return Element reference.
+     */
+    constexpr T &
+    operator[](
+            std::size_t const index
+    ) const
+    {
+        return mData[index];
+    }
+
+    /**
+     * Create a view on a part of this span.
+     * @param offset Index of first element of the sub-span.
+     * @param count Count of elements, trimmed to the end of this span.
+     * @return Sub-span.
+     */
+    constexpr Span
+    subspan(
+            std::size_t const offset,
+            std::size_t const count
+    ) const
+    {
+        assert(offset <= mSize);
+        return Span{mData + offset, std::min(count, mSize - offset)};
+    }
+
+private:
+
+    T *mData{nullptr};
+    std::size_t mSize{0};
+
+};
@@ -0,0 +1,113 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free exchange of values between exactly one producer thread and one consumer thread.
+ *
+ * The producer writes into its back slot and publishes it, the consumer picks up the most recently published slot.
+ * Neither side ever blocks or waits for the other: Publishing overwrites a value the consumer has not picked up yet,
+ * so the consumer always sees the latest value and the producer can run at its own rate.
+ *
+ * Slots are reused, so values holding memory (e.g. vectors) do not cause allocations once their capacity suffices.
+ */
+template<class T>
+class TripleBuffer
+{
+
+public:
+
+    TripleBuffer() = default;
+
+    TripleBuffer(TripleBuffer const &) = delete;
+
+    TripleBuffer &
+    operator=(TripleBuffer const &) = delete;
+
+    /**
+     * Give the slot the producer writes into. Only call this from the producer thread.
+     * @attention The slot contains an older value, not necessarily the most recently published one.
+     * @return Back slot.
+     */
+    T &
+    back()
+    {
+        return mSlots[mBack].value;
+    }
+
+    /**
+     * Publish the back slot, making it available to the consumer. Only call this from the producer thread.
+     * Afterwards, `back()` refers to another slot.
+     */
+    void
+    publish()
+    {
+        mBack = mMiddle.exchange(mBack | fresh(), std::memory_order_acq_rel) & index();
+    }
+
+    /**
+     * Pick up the most recently published value, if any was published since the last call.
+     * Only call this from the consumer thread.
+     * @return True if `front()` changed.
+     */
+    bool
+    update()
+    {
+        if (!(mMiddle.load(std::memory_order_relaxed) & fresh()))
+        {
+            return false;
+        }
+        mFront = mMiddle.exchange(mFront, std::memory_order_acq_rel) & index();
+        return true;
+    }
+
+    /**
+     * Give the slot the consumer reads from. Only call this from the consumer thread.
+     * @return Front slot, i.e. the value picked up by the last successful `update()`.
+     */
+    T const &
+    front() const
+    {
+        return mSlots[mFront].value;
+    }
+
+private:
+
+    /**
+     * Slots are padded to separate cache lines, avoiding false sharing between producer and consumer.
+     */
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    /**
+     * Bit marking the middle slot as not picked up by the consumer yet.
+     */
+    static constexpr std::uint8_t
+    fresh()
+    {
+        return 0b100;
+    }
+
+    /**
+     * Bits denoting the slot index.
+     */
+    static constexpr std::uint8_t
+    index()
+    {
+        return 0b011;
+    }
+
+    std::array<Slot, 3> mSlots;
+    std::uint8_t mBack{0};              ///< Owned by producer
+    std::atomic<std::uint8_t> mMiddle{1}; ///< Shared, slot index and fresh bit
+    std::uint8_t mFront{2};             ///< Owned by consumer
+
+};
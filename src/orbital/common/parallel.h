@@ -0,0 +1,281 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/**
+ * Give the count of threads to use for a given amount of work.
+ * @param count Count of work items.
+ * @param minimumPerThread Minimum count of work items a thread should process to be worth spawning.
+ * @param threads Maximum count of threads. 0 means as many as there are hardware threads.
+ * @return Count of threads, at least 1.
+ */
+inline std::size_t
+threadCount(
+        std::size_t const count,
+        std::size_t const minimumPerThread,
+        std::size_t threads = 0
+)
+{
+    if (0 == threads)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return std::max<std::size_t>(1, std::min(threads, count / std::max<std::size_t>(minimumPerThread, 1)));
+}
+
+/**
+ * Threads waiting for chunks of work, kept across calls, so work split up many times per step does not spawn threads
+ * each time.
+ *
+ * Workers are started by the first call needing them, and joined on destruction. If a worker cannot be started, the
+ * calling thread processes its chunks instead. A pool processes one call at a time, so chunks must not call into the
+ * pool processing them.
+ */
+class WorkerPool
+{
+
+public:
+
+    WorkerPool() = default;
+
+    /**
+     * Copies do not share workers, but start their own, so owners of a pool stay copyable.
+     */
+    WorkerPool(
+            WorkerPool const &
+    )
+            : WorkerPool{}
+    {
+    }
+
+    WorkerPool &
+    operator=(
+            WorkerPool const &
+    )
+    {
+        return *this;
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard lock{mMutex};
+            mStopping = true;
+        }
+        mWork.notify_all();
+        for (auto &worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * Process chunks by the workers and the calling thread, and return after all chunks have been processed.
+     * @param chunks Count of chunks.
+     * @param fun Function called for each chunk: `fun(chunkIndex)`. Must not throw.
+     */
+    template<class TFun>
+    void
+    run(
+            std::size_t const chunks,
+            TFun &fun
+    )
+    {
+        Job job{chunks, &fun, [](
+                void *const fun,
+                std::size_t const chunk
+        ) {
+            (*static_cast<TFun *>(fun))(chunk);
+        }};
+        start(chunks - 1);
+
+        std::unique_lock lock{mMutex};
+        mJob = &job;
+        lock.unlock();
+        mWork.notify_all();
+
+        lock.lock();
+        process(lock);
+        mDone.wait(lock, [&] {
+            return job.finished == job.chunks;
+        });
+    }
+
+    /**
+     * @return Count of workers started so far.
+     */
+    std::size_t
+    size() const
+    {
+        std::lock_guard lock{mMutex};
+        return mWorkers.size();
+    }
+
+private:
+
+    struct Job
+    {
+        std::size_t chunks;
+        void *fun;
+        void (*call)(void *, std::size_t);
+        std::size_t claimed{0};
+        std::size_t finished{0};
+    };
+
+    /**
+     * Start workers until there are at least the given count.
+     */
+    void
+    start(
+            std::size_t const count
+    )
+    {
+        std::lock_guard lock{mMutex};
+        try
+        {
+            while (mWorkers.size() < count)
+            {
+                mWorkers.emplace_back([this] {
+                    work();
+                });
+            }
+        }
+        catch (std::system_error const &)
+        {
+            // Fewer workers leave more chunks to the calling thread:
+        }
+    }
+
+    /**
+     * Claim and process chunks of the current job until all are claimed.
+     * @param lock Lock of `mMutex`, held on entry and exit, released while processing.
+     */
+    void
+    process(
+            std::unique_lock<std::mutex> &lock
+    )
+    {
+        while (mJob)
+        {
+            auto &job = *mJob;
+            auto const chunk = job.claimed++;
+            if (job.claimed == job.chunks)
+            {
+                mJob = nullptr;
+            }
+
+            lock.unlock();
+            job.call(job.fun, chunk);
+            lock.lock();
+
+            // The job lives on the stack of the calling thread, which returns once this is done:
+            if (++job.finished == job.chunks)
+            {
+                mDone.notify_all();
+            }
+        }
+    }
+
+    void
+    work()
+    {
+        std::unique_lock lock{mMutex};
+        while (true)
+        {
+            mWork.wait(lock, [&] {
+                return mStopping || mJob;
+            });
+            if (mStopping)
+            {
+                return;
+            }
+            process(lock);
+        }
+    }
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWork;
+    std::condition_variable mDone;
+    std::vector<std::thread> mWorkers;
+    Job *mJob{nullptr};                 ///< Job with unclaimed chunks, if any
+    bool mStopping{false};
+
+};
+
+/**
+ * Split the range \f$ [0, count) \f$ into contiguous chunks of roughly equal size, and process each chunk by a worker
+ * of the pool or by the calling thread, which returns after all chunks have been processed.
+ * @param workers Pool to process chunks by.
+ * @param count Count of work items.
+ * @param threads Count of chunks, i.e. threads to use. Pass the result of `threadCount()`.
+ * @param fun Function called for each chunk: `fun(begin, end, chunkIndex)`.
+ * @throw Rethrows the first exception thrown by any chunk.
+ */
+template<class TFun>
+void
+parallelChunks(
+        WorkerPool &workers,
+        std::size_t const count,
+        std::size_t const threads,
+        TFun &&fun
+)
+{
+    if (threads <= 1)
+    {
+        fun(std::size_t{0}, count, std::size_t{0});
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    auto process = [&](std::size_t const chunk) {
+        try
+        {
+            fun(count * chunk / threads, count * (chunk + 1) / threads, chunk);
+        }
+        catch (...)
+        {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    workers.run(threads, process);
+
+    for (auto const &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * Like `parallelChunks()` on a pool, but by threads started for this call only. Use a `WorkerPool` for work repeated
+ * many times per second.
+ */
+template<class TFun>
+void
+parallelChunks(
+        std::size_t const count,
+        std::size_t const threads,
+        TFun &&fun
+)
+{
+    if (threads <= 1)
+    {
+        fun(std::size_t{0}, count, std::size_t{0});
+        return;
+    }
+
+    WorkerPool workers;
+    parallelChunks(workers, count, threads, std::forward<TFun>(fun));
+}
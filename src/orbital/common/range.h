@@ -5,15 +5,18 @@
 #pragma once
 
 #include <functional>
+#include <type_traits>
 
 /**
  * Executes a function over a given range. The current index is passed as a parameter.
+ * For overloads taking an execution policy, see range_parallel.h.
  * @param min Lower range bound, inclusive.
  * @param max Upper range bound, exclusive.
  * @param fun Function to call.
- * @param args Arguments to pass, see std::apply().
+ * @param args Arguments to pass, see std::invoke().
  */
-template<class TMin, class TMax, class... TArgs, class TFun>
+template<class TMin, class TMax, class... TArgs, class TFun, class = std::enable_if_t<
+        std::is_invocable_v<TFun &, TArgs &..., TMin>>>
 constexpr void
 range(
         TMin const min,
@@ -22,13 +25,10 @@ range(
         TArgs &&...args
 )
 {
-    if (!(min < max))
+    for (auto i = min; i < max; i = i + TMin(1))
     {
-        return;
+        std::invoke(fun, args..., i);
     }
-
-    std::apply(std::forward<TFun>(fun), std::tuple{std::forward<TFun>(args)..., min});
-    range(min + TMin(1), max, std::forward<TFun>(fun), std::forward<TFun>(args)...);
 }
 
 /**
@@ -37,8 +37,8 @@ range(
  * @param min Lower range bound, inclusive.
  * @param max Upper range bound, exclusive.
  * @param init Initializer value, value passed to first invocation of fun.
- * @param fun Function to call. Arguments to `std::apply()` in that order: `fun`, `args`, `init`, `<current index>`.
- * @param args Arguments to pass, see std::apply().
+ * @param fun Function to call. Arguments to `std::invoke()` in that order: `fun`, `args`, `init`, `<current index>`.
+ * @param args Arguments to pass, see std::invoke().
  * @return Return value from last invocation.
  */
 template<class TBounds, class T, class... TArgs, class TFun>
@@ -51,11 +51,10 @@ reduce_range(
         TArgs &&...args
 )
 {
-    if (!(min < max))
+    T result = init;
+    for (auto i = min; i < max; i = i + TBounds(1))
     {
-        return init;
+        result = std::invoke(fun, args..., result, i);
     }
-
-    auto result = std::apply(std::forward<TFun>(fun), std::tuple{std::forward<TFun>(args)..., init, min});
-    return reduce_range(min + TBounds(1), max, result, std::forward<TFun>(fun), std::forward<TFun>(args)...);
+    return result;
 }
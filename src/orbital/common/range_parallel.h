@@ -0,0 +1,166 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <execution>
+#include <vector>
+#include "parallel.h"
+#include "range.h"
+
+/**
+ * \file range_parallel.h Overloads of `range()` and `reduce_range()` taking an execution policy. Kept apart from
+ * range.h, since `<execution>` is expensive to compile, and only the parallel callers need it.
+ */
+
+/**
+ * True for the standard execution policies allowing parallel execution.
+ */
+template<class TPolicy>
+constexpr bool isParallelPolicy = std::is_execution_policy_v<std::decay_t<TPolicy>> &&
+        !std::is_same_v<std::decay_t<TPolicy>, std::execution::sequenced_policy>;
+
+/**
+ * Split \f$ [0, count) \f$ into chunks, and process them in parallel according to the given policy.
+ * Chunks are handed out to threads dynamically, so uneven work per chunk is balanced.
+ * @param policy Execution policy. Sequenced execution processes all chunks by the calling thread, in order.
+ * @param count Count of indices.
+ * @param chunkSize Count of indices per chunk, 0 is taken as 1.
+ * @param fun Function called per chunk: `fun(begin, end, chunkIndex)`.
+ */
+template<class TPolicy, class TFun>
+void
+forEachChunk(
+        TPolicy &&,
+        std::size_t const count,
+        std::size_t chunkSize,
+        TFun &&fun
+)
+{
+    chunkSize = std::max<std::size_t>(1, chunkSize);
+    std::size_t const chunks = (count + chunkSize - 1) / chunkSize;
+    auto process = [&](std::size_t const chunk) {
+        fun(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize), chunk);
+    };
+
+    if constexpr (!isParallelPolicy<TPolicy>)
+    {
+        for (std::size_t chunk = 0; chunk < chunks; chunk++)
+        {
+            process(chunk);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    parallelChunks(chunks, threadCount(chunks, 1), [&](std::size_t, std::size_t, std::size_t) {
+        for (auto chunk = next++; chunk < chunks; chunk = next++)
+        {
+            process(chunk);
+        }
+    });
+}
+
+/**
+ * Executes a function over a given range, by multiple threads if the policy allows.
+ * The function is called exactly once per index, in unspecified order, so it must be safe to call concurrently.
+ * @param policy Execution policy, e.g. `std::execution::par`.
+ * @param min Lower range bound, inclusive.
+ * @param max Upper range bound, exclusive.
+ * @param fun Function to call with the current index.
+ * @param chunkSize Count of consecutive indices processed by a thread at once. Should be large enough to outweigh
+ * scheduling overhead. 0 is taken as 1.
+ */
+template<class TPolicy, class TBounds, class TFun, class = std::enable_if_t<
+        std::is_execution_policy_v<std::decay_t<TPolicy>>>>
+void
+range(
+        TPolicy &&policy,
+        TBounds const min,
+        TBounds const max,
+        TFun &&fun,
+        std::size_t const chunkSize = 4096
+)
+{
+    if (!(min < max))
+    {
+        return;
+    }
+
+    forEachChunk(policy, static_cast<std::size_t>(max - min), chunkSize, [&](
+            std::size_t const begin,
+            std::size_t const end,
+            std::size_t
+    ) {
+        for (auto i = begin; i < end; i++)
+        {
+            fun(static_cast<TBounds>(min + static_cast<TBounds>(i)));
+        }
+    });
+}
+
+/**
+ * Reduces a given range, by multiple threads if the policy allows.
+ *
+ * The range is split into chunks of consecutive indices. Each chunk is reduced by `fun` starting from `identity`, and
+ * the chunk results are then combined in index order. The result does therefore not depend on the count of threads,
+ * which keeps floating point reductions reproducible.
+ *
+ * @param policy Execution policy, e.g. `std::execution::par`.
+ * @param min Lower range bound, inclusive.
+ * @param max Upper range bound, exclusive.
+ * @param identity Value each chunk's reduction starts from, must be an identity of `combine`.
+ * @param fun Function reducing a single index: `fun(accumulated, index)`. Must be safe to call concurrently.
+ * @param combine Function combining two chunk results: `combine(left, right)`. Must be associative.
+ * @param chunkSize Count of consecutive indices reduced by a thread at once, 0 is taken as 1.
+ * @return Combined result, `identity` for an empty range.
+ */
+template<class TPolicy, class TBounds, class T, class TFun, class TCombine, class = std::enable_if_t<
+        std::is_execution_policy_v<std::decay_t<TPolicy>>>>
+T
+reduce_range(
+        TPolicy &&policy,
+        TBounds const min,
+        TBounds const max,
+        T const identity,
+        TFun &&fun,
+        TCombine &&combine,
+        std::size_t chunkSize = 4096
+)
+{
+    chunkSize = std::max<std::size_t>(1, chunkSize);
+    if (!(min < max))
+    {
+        return identity;
+    }
+
+    // Wrapped, so a std::vector<bool> does not pack concurrently written results into shared words:
+    struct Result
+    {
+        T value;
+    };
+
+    std::size_t const count = static_cast<std::size_t>(max - min);
+    std::vector<Result> results((count + chunkSize - 1) / chunkSize, Result{identity});
+    forEachChunk(policy, count, chunkSize, [&](
+            std::size_t const begin,
+            std::size_t const end,
+            std::size_t const chunk
+    ) {
+        T result = identity;
+        for (auto i = begin; i < end; i++)
+        {
+            result = fun(result, static_cast<TBounds>(min + static_cast<TBounds>(i)));
+        }
+        results[chunk].value = result;
+    });
+
+    T result = identity;
+    for (auto const &chunkResult : results)
+    {
+        result = combine(result, chunkResult.value);
+    }
+    return result;
+}
@@ -0,0 +1,179 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include <algorithm>
+#include <mutex>
+#include "fmt/format.h"
+#include "trace.h"
+
+namespace
+{
+
+/**
+ * All buffers ever created. Buffers are shared, so they can still be exported after their thread exited.
+ */
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    std::vector<std::shared_ptr<TraceBuffer>> released;     ///< Buffers of exited threads, to be reused
+};
+
+Registry &
+registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+/**
+ * Holds the buffer of a thread while it runs, and releases it for reuse by a later thread when it exits.
+ * Threads outside a `WorkerPool` are spawned anew for each parallel call, so without reuse the registry would grow
+ * without bounds.
+ */
+class BufferLease
+{
+
+public:
+
+    BufferLease()
+    {
+        auto &registry = ::registry();
+        std::lock_guard lock{registry.mutex};
+        if (registry.released.empty())
+        {
+            auto const thread = static_cast<std::uint32_t>(registry.buffers.size() + 1);
+            mBuffer = registry.buffers.emplace_back(std::make_shared<TraceBuffer>(thread));
+        }
+        else
+        {
+            // Keeps the zones recorded by the previous owner, so they are still exported:
+            mBuffer = std::move(registry.released.back());
+            registry.released.pop_back();
+        }
+    }
+
+    ~BufferLease()
+    {
+        auto &registry = ::registry();
+        std::lock_guard lock{registry.mutex};
+        registry.released.push_back(std::move(mBuffer));
+    }
+
+    BufferLease(BufferLease const &) = delete;
+
+    BufferLease &
+    operator=(BufferLease const &) = delete;
+
+    TraceBuffer &
+    buffer() const
+    {
+        return *mBuffer;
+    }
+
+private:
+
+    std::shared_ptr<TraceBuffer> mBuffer;
+
+};
+
+}
+
+TraceBuffer::TraceBuffer(
+        std::uint32_t const thread
+)
+        : mThread{thread}
+        , mEvents{new TraceEvent[capacity()]}
+{
+}
+
+void
+TraceBuffer::collect(
+        std::vector<TraceEvent> &events
+) const
+{
+    auto const count = mCount.load(std::memory_order_acquire);
+    auto const first = count > capacity() ? count - capacity() : 0;
+    for (auto i = first; i < count; i++)
+    {
+        events.push_back(mEvents[i & (capacity() - 1)]);
+    }
+}
+
+void
+TraceBuffer::clear()
+{
+    mCount.store(0, std::memory_order_release);
+}
+
+std::uint32_t
+TraceBuffer::thread() const
+{
+    return mThread;
+}
+
+TraceBuffer &
+Trace::buffer()
+{
+    // Leasing takes a lock, but only once per thread:
+    thread_local BufferLease lease;
+    return lease.buffer();
+}
+
+std::vector<std::pair<std::uint32_t, std::vector<TraceEvent>>>
+Trace::collect()
+{
+    auto &registry = ::registry();
+    std::lock_guard lock{registry.mutex};
+
+    std::vector<std::pair<std::uint32_t, std::vector<TraceEvent>>> result;
+    for (auto const &buffer : registry.buffers)
+    {
+        auto &[thread, events] = result.emplace_back(buffer->thread(), std::vector<TraceEvent>{});
+        buffer->collect(events);
+    }
+    return result;
+}
+
+void
+Trace::clear()
+{
+    auto &registry = ::registry();
+    std::lock_guard lock{registry.mutex};
+    for (auto const &buffer : registry.buffers)
+    {
+        buffer->clear();
+    }
+}
+
+void
+Trace::write(
+        std::ostream &os
+)
+{
+    auto const threads = collect();
+
+    // Timestamps in microseconds, relative to the earliest zone, so they stay readable:
+    auto origin = UINT64_MAX;
+    for (auto const &[thread, events] : threads)
+    {
+        for (auto const &event : events)
+        {
+            origin = std::min(origin, event.begin);
+        }
+    }
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char const *separator = "\n";
+    for (auto const &[thread, events] : threads)
+    {
+        for (auto const &event : events)
+        {
+            os << fmt::format("{}{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    separator, event.name, thread, (event.begin - origin) / 1e3, (event.end - event.begin) / 1e3);
+            separator = ",\n";
+        }
+    }
+    os << "\n]}\n";
+}
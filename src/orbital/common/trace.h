@@ -0,0 +1,218 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+/**
+ * \file trace.h Scoped-zone tracer for hot paths.
+ *
+ * Zones are recorded into a ring buffer per thread, so recording takes no locks and never contends with other
+ * threads. When a ring buffer is full, the oldest zones are overwritten. Recorded zones can be exported as Chrome
+ * `trace_event` JSON, to be inspected in `chrome://tracing` or [Perfetto](https://ui.perfetto.dev).
+ *
+ * Zones are placed with `TRACE_ZONE()`, which compiles to nothing unless `ORBITAL_TRACING` is defined, see the
+ * CMake option of the same name.
+ */
+
+/**
+ * A finished zone.
+ */
+struct TraceEvent
+{
+    char const *name{nullptr};      ///<        Zone name, must be a string literal
+    std::uint64_t begin{0};         ///< [ns]   Start, relative to the steady clock's epoch
+    std::uint64_t end{0};           ///< [ns]   End, relative to the steady clock's epoch
+};
+
+/**
+ * Ring buffer of zones recorded by a single thread.
+ */
+class TraceBuffer
+{
+
+public:
+
+    /**
+     * @param thread Thread id used in exports.
+     */
+    explicit TraceBuffer(
+            std::uint32_t thread
+    );
+
+    /**
+     * Record a zone. Only called by the owning thread.
+     * @param event Finished zone.
+     */
+    void
+    push(
+            TraceEvent const &event
+    )
+    {
+        auto const index = mCount.load(std::memory_order_relaxed);
+        mEvents[index & (capacity() - 1)] = event;
+        mCount.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * Copy the recorded zones, oldest first.
+     * Zones pushed concurrently may be torn, so only read when the owning thread is quiescent for accurate results.
+     * @param events Vector to append to.
+     */
+    void
+    collect(
+            std::vector<TraceEvent> &events
+    ) const;
+
+    /**
+     * Forget all recorded zones.
+     */
+    void
+    clear();
+
+    /**
+     * @return Thread id used in exports.
+     */
+    std::uint32_t
+    thread() const;
+
+    /**
+     * @return Count of zones kept per thread, must be a power of two.
+     */
+    static constexpr std::size_t
+    capacity()
+    {
+        return 1u << 16u;
+    }
+
+private:
+
+    std::uint32_t mThread;
+    std::atomic<std::uint64_t> mCount{0};   ///<        Count of zones pushed since the last clear
+    std::unique_ptr<TraceEvent[]> mEvents;
+
+};
+
+/**
+ * Global access to all threads' trace buffers.
+ */
+class Trace
+{
+
+public:
+
+    /**
+     * @return True if `TRACE_ZONE()` records zones, i.e. if built with `ORBITAL_TRACING`.
+     */
+    static constexpr bool
+    enabled()
+    {
+#ifdef ORBITAL_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @return [ns] Current time, relative to the steady clock's epoch.
+     */
+    static std::uint64_t
+    now()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * Buffer of the calling thread, taken on first use. When the thread exits, its buffer stays registered and is
+     * reused by the next thread taking one, so the count of buffers is bounded by the count of threads running at once.
+     * Zones of all threads which used a buffer are exported with the thread id of the buffer.
+     * @return Buffer of the calling thread.
+     */
+    static TraceBuffer &
+    buffer();
+
+    /**
+     * Copy the zones recorded by all threads.
+     * @return Events, grouped by thread.
+     */
+    static std::vector<std::pair<std::uint32_t, std::vector<TraceEvent>>>
+    collect();
+
+    /**
+     * Forget the zones recorded by all threads.
+     */
+    static void
+    clear();
+
+    /**
+     * Export the zones recorded by all threads as Chrome `trace_event` JSON.
+     * @param os Stream to write to.
+     */
+    static void
+    write(
+            std::ostream &os
+    );
+
+};
+
+/**
+ * Records the lifetime of a scope as a zone.
+ */
+class TraceZone
+{
+
+public:
+
+    /**
+     * Start the zone.
+     * @param name Zone name, must be a string literal or otherwise outlive the trace.
+     */
+    explicit TraceZone(
+            char const *name
+    )
+            : mName{name}
+            , mBegin{Trace::now()}
+    {
+    }
+
+    /**
+     * End the zone and record it.
+     */
+    ~TraceZone()
+    {
+        Trace::buffer().push({mName, mBegin, Trace::now()});
+    }
+
+    TraceZone(TraceZone const &) = delete;
+
+    TraceZone &
+    operator=(TraceZone const &) = delete;
+
+private:
+
+    char const *mName;
+    std::uint64_t mBegin;
+
+};
+
+#define ORBITAL_TRACE_CONCAT_IMPL(a, b) a##b
+#define ORBITAL_TRACE_CONCAT(a, b) ORBITAL_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef ORBITAL_TRACING
+/**
+ * Record the rest of the enclosing scope as a zone.
+ * @param name Zone name, must be a string literal.
+ */
+#define TRACE_ZONE(name) TraceZone const ORBITAL_TRACE_CONCAT(traceZone, __LINE__){name}
+#else
+#define TRACE_ZONE(name) static_cast<void>(0)
+#endif
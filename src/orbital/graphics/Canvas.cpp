@@ -0,0 +1,286 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "Canvas.h"
+#include <orbital/common/convert.h>
+#include <orbital/common/trace.h>
+#include <orbital/math/elementary.h>
+
+Canvas::Canvas(
+        std::size_t const width,
+        std::size_t const height,
+        Channels const channels
+)
+        : mWidth{width}
+        , mHeight{height}
+        , mChannels{channels}
+{
+    if (0 == width || 0 == height)
+    {
+        throw std::runtime_error{"canvas cannot have 0 pixels"};
+    }
+
+    mPixels.resize(width * height * static_cast<std::size_t>(channels));
+
+    // Span over whole viewport
+    Transform<Decimal> projection;
+    projection.scale({width / 2.0, height / 2.0});
+
+    // Origin should sit in the center
+    projection.translate({1, 1});
+
+    // Y-Axis should point upwards
+    projection.scale({1, -1});
+
+    // Scale against viewport distort, pixels are square
+    projection.scale({height / static_cast<Decimal>(width), 1});
+
+    project(projection);
+}
+
+void
+Canvas::clear(
+        Color const color
+)
+{
+    auto const previous = mColor;
+    this->color(color);
+    auto const channels = static_cast<std::size_t>(mChannels);
+    for (std::size_t i = 0; i < mPixels.size(); i += channels)
+    {
+        std::copy(mColor.begin(), mColor.begin() + channels, mPixels.begin() + i);
+    }
+    mColor = previous;
+}
+
+void
+Canvas::color(
+        Color const color
+)
+{
+    if (Channels::Gray == mChannels)
+    {
+        // Rec. 601 luma:
+        mColor[0] = static_cast<std::uint8_t>(std::lround(0.299 * color.r + 0.587 * color.g + 0.114 * color.b));
+    }
+    else
+    {
+        mColor = {{color.r, color.g, color.b}};
+    }
+}
+
+void
+Canvas::point(
+        WorldVector const &worldVector
+)
+{
+    splat(mapToFramebuffer(worldVector));
+}
+
+void
+Canvas::points(
+        Span<vec const> const worldVectors
+)
+{
+    TRACE_ZONE("Canvas::points");
+    std::array<vec, 256> mapped;
+    for (std::size_t offset = 0; offset < worldVectors.size(); offset += mapped.size())
+    {
+        auto const chunk = worldVectors.subspan(offset, mapped.size());
+        mTransform.applyBatch(chunk, {mapped.data(), chunk.size()});
+        for (std::size_t i = 0; i < chunk.size(); i++)
+        {
+            splat(FramebufferVector{mapped[i].x, mapped[i].y});
+        }
+    }
+}
+
+void
+Canvas::ellipse(
+        Ellipse<Decimal> const &ellipse
+)
+{
+    TRACE_ZONE("Canvas::ellipse");
+    // Skip ellipse rendering if the viewport is completely contained by the ellipse shape,
+    // i.e. no lines are visible anyway.
+    vec ll = mapToWorld({0, mHeight - 1});
+    vec ur = mapToWorld({mWidth - 1, 0});
+    if (ellipse.contains(Rectangle<Decimal>{ll, ur}))
+    {
+        return;
+    }
+
+    // The stepper relies on arcs lying within one quadrant:
+    stepper(ellipse, 0_pi, 0.5_pi);
+    stepper(ellipse, 0.5_pi, 1_pi);
+    stepper(ellipse, 1_pi, 1.5_pi);
+    stepper(ellipse, 1.5_pi, 2_pi);
+}
+
+std::size_t
+Canvas::width() const
+{
+    return mWidth;
+}
+
+std::size_t
+Canvas::height() const
+{
+    return mHeight;
+}
+
+Canvas::Channels
+Canvas::channels() const
+{
+    return mChannels;
+}
+
+Span<std::uint8_t const>
+Canvas::pixels() const
+{
+    return mPixels;
+}
+
+void
+Canvas::blend(
+        std::ptrdiff_t const x,
+        std::ptrdiff_t const y,
+        Decimal const coverage
+)
+{
+    if (x < 0 || y < 0 || x >= static_cast<std::ptrdiff_t>(mWidth) || y >= static_cast<std::ptrdiff_t>(mHeight))
+    {
+        return;
+    }
+
+    auto const channels = static_cast<std::size_t>(mChannels);
+    std::uint8_t *pixel = &mPixels[(y * mWidth + x) * channels];
+    for (std::size_t c = 0; c < channels; c++)
+    {
+        pixel[c] = static_cast<std::uint8_t>(std::lround(pixel[c] + (mColor[c] - pixel[c]) * coverage));
+    }
+}
+
+void
+Canvas::splat(
+        FramebufferVector const &v
+)
+{
+    // Pixel centers lie at .5, so shift them onto integral coordinates:
+    Decimal const x = v.x - 0.5;
+    Decimal const y = v.y - 0.5;
+
+    // Points not touching the canvas are skipped before converting to integers, which could overflow far off-canvas.
+    // Negated, so NaN is skipped as well:
+    if (!(x > -1 && x < mWidth && y > -1 && y < mHeight))
+    {
+        return;
+    }
+
+    Decimal const x0 = std::floor(x);
+    Decimal const y0 = std::floor(y);
+    Decimal const fx = x - x0;
+    Decimal const fy = y - y0;
+
+    auto const px = static_cast<std::ptrdiff_t>(x0);
+    auto const py = static_cast<std::ptrdiff_t>(y0);
+    blend(px, py, (1 - fx) * (1 - fy));
+    blend(px + 1, py, fx * (1 - fy));
+    blend(px, py + 1, (1 - fx) * fy);
+    blend(px + 1, py + 1, fx * fy);
+}
+
+void
+Canvas::line(
+        FramebufferVector const from,
+        FramebufferVector const to
+)
+{
+    // Pixel centers lie at .5, so shift them onto integral coordinates:
+    Decimal x0 = from.x - 0.5;
+    Decimal y0 = from.y - 0.5;
+    Decimal x1 = to.x - 0.5;
+    Decimal y1 = to.y - 0.5;
+
+    // Always step along the major axis, so each step covers exactly one pixel column (or row, if steep):
+    bool const steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+    if (steep)
+    {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1)
+    {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+
+    Decimal const gradient = x1 - x0 > 0 ? (y1 - y0) / (x1 - x0) : 0;
+
+    // The end column is exclusive, so consecutive lines of a poly-line do not paint their joints twice:
+    for (Decimal x = std::ceil(x0); x < x1; x++)
+    {
+        Decimal const y = y0 + gradient * (x - x0);
+        Decimal const yi = std::floor(y);
+        Decimal const f = y - yi;
+
+        auto const major = static_cast<std::ptrdiff_t>(x);
+        auto const minor = static_cast<std::ptrdiff_t>(yi);
+        if (steep)
+        {
+            blend(minor, major, 1 - f);
+            blend(minor + 1, major, f);
+        }
+        else
+        {
+            blend(major, minor, 1 - f);
+            blend(major, minor + 1, f);
+        }
+    }
+}
+
+void
+Canvas::stepper(
+        Ellipse<Decimal> const &ellipse,
+        Radian<Decimal> const ts,
+        Radian<Decimal> const te
+)
+{
+    auto const ps = ellipse.point<FastTrig>(ts);
+    auto const pe = ellipse.point<FastTrig>(te);
+
+    // Within one quadrant both coordinates are monotonic, so the arc lies within the box spanned by its end points.
+    // If that box is completely outside the canvas, so is the arc:
+    std::array<FramebufferVector, 4> const box{{
+            mapToFramebuffer(WorldVector{ps.x, ps.y}),
+            mapToFramebuffer(WorldVector{pe.x, ps.y}),
+            mapToFramebuffer(WorldVector{ps.x, pe.y}),
+            mapToFramebuffer(WorldVector{pe.x, pe.y})
+    }};
+    auto const outside = [&](auto const &predicate) {
+        return std::all_of(box.begin(), box.end(), predicate);
+    };
+    if (outside([](auto const &v) { return v.x < 0; }) || outside([](auto const &v) { return v.y < 0; }) ||
+            outside([&](auto const &v) { return v.x >= mWidth; }) ||
+            outside([&](auto const &v) { return v.y >= mHeight; }))
+    {
+        return;
+    }
+
+    FramebufferVector const &fs = box[0];
+    FramebufferVector const &fe = box[3];
+
+    if (2 < vectorDistance(fs, fe))
+    {
+        // Chord is too long to approximate the arc, continue stepping in smaller steps:
+        Radian<Decimal> const ta = average(ts, te);
+        stepper(ellipse, ts, ta);
+        stepper(ellipse, ta, te);
+    }
+
+    else
+    {
+        line(fs, fe);
+    }
+}
@@ -0,0 +1,193 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <orbital/common/common.h>
+#include <orbital/common/Span.h>
+#include <orbital/math/Ellipse.h>
+#include "FramebufferVector.h"
+#include "TransformStack.h"
+
+/**
+ * Paints anti-aliased graphics into an offscreen pixel buffer of arbitrary resolution, e.g. to produce images or
+ * video frames of the same scenes drawn by `Graphics`.
+ * Provides the same transformation stack as `Graphics`. Pixels are square, and the world coordinate range
+ * \f$ [-1, 1] \f$ spans over the canvas height.
+ */
+class Canvas
+        : public TransformStack
+{
+
+public:
+
+    /**
+     * Channels per pixel.
+     */
+    enum class Channels
+    {
+        Gray = 1,
+        Rgb = 3
+    };
+
+    /**
+     * Drawing color. Converted to luminance when painting a grayscale canvas.
+     */
+    struct Color
+    {
+        std::uint8_t r;
+        std::uint8_t g;
+        std::uint8_t b;
+    };
+
+    /**
+     * Create a new canvas of a given size, cleared to black.
+     * Pushes an initial layer of transformation.
+     * @param width Count of pixels horizontally.
+     * @param height Count of pixels vertically.
+     * @param channels Channels per pixel.
+     */
+    Canvas(
+            std::size_t width,
+            std::size_t height,
+            Channels channels = Channels::Rgb
+    );
+
+    /**
+     * Fill the whole canvas with a color.
+     * @param color Fill color.
+     */
+    void
+    clear(
+            Color color = {0, 0, 0}
+    );
+
+    /**
+     * Set the color used by following drawing operations.
+     * @param color Drawing color.
+     */
+    void
+    color(
+            Color color
+    );
+
+    /**
+     * Draw an anti-aliased point, i.e. a pixel-sized dot which is distributed over its neighbouring pixels.
+     * @param worldVector Untransformed position.
+     */
+    void
+    point(
+            WorldVector const &worldVector
+    );
+
+    /**
+     * Draw many anti-aliased points at once.
+     * @param worldVectors Untransformed positions.
+     */
+    void
+    points(
+            Span<vec const> worldVectors
+    );
+
+    /**
+     * Draw an anti-aliased ellipse outline.
+     * @param ellipse Ellipse to draw.
+     */
+    void
+    ellipse(
+            Ellipse<Decimal> const &ellipse
+    );
+
+    /**
+     * @return Count of pixels horizontally.
+     */
+    std::size_t
+    width() const;
+
+    /**
+     * @return Count of pixels vertically.
+     */
+    std::size_t
+    height() const;
+
+    /**
+     * @return Channels per pixel.
+     */
+    Channels
+    channels() const;
+
+    /**
+     * @return Row major pixel data, top row first, with interleaved channels.
+     */
+    Span<std::uint8_t const>
+    pixels() const;
+
+private:
+
+    std::size_t mWidth;
+    std::size_t mHeight;
+    Channels mChannels;
+
+    /**
+     * Drawing color, one value per channel.
+     */
+    std::array<std::uint8_t, 3> mColor{{255, 255, 255}};
+
+    /**
+     * Row major pixel data.
+     */
+    std::vector<std::uint8_t> mPixels;
+
+    /**
+     * Blend the drawing color into a pixel.
+     * Pixels outside of the canvas are ignored.
+     * @param x Pixel column.
+     * @param y Pixel row.
+     * @param coverage Fraction of the pixel covered, \f$ [0, 1] \f$.
+     */
+    void
+    blend(
+            std::ptrdiff_t x,
+            std::ptrdiff_t y,
+            Decimal coverage
+    );
+
+    /**
+     * Distribute a dot at a framebuffer location bilinearly over its four neighbouring pixels.
+     * @param v Framebuffer location.
+     */
+    void
+    splat(
+            FramebufferVector const &v
+    );
+
+    /**
+     * Draw an anti-aliased line using Xiaolin Wu's algorithm.
+     * @param from Start in framebuffer space.
+     * @param to End in framebuffer space, exclusive.
+     */
+    void
+    line(
+            FramebufferVector from,
+            FramebufferVector to
+    );
+
+    /**
+     * Internal function, used to render ellipses. Subdivides the arc until its chord is short enough to be drawn as
+     * a line. Evaluates points with `FastTrig`, whose error is far below a pixel.
+     * @attention The arc between ts and te must not cross any of the ellipse's axes, i.e. lie within one quadrant.
+     * @param ellipse Ellipse to render.
+     * @param ts Start ellipse parameter.
+     * @param te End ellipse parameter.
+     */
+    void
+    stepper(
+            Ellipse<Decimal> const &ellipse,
+            Radian<Decimal> ts,
+            Radian<Decimal> te
+    );
+
+};
@@ -0,0 +1,149 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "FrameWriter.h"
+#include <fstream>
+#include <orbital/common/trace.h>
+
+FrameWriter::FrameWriter(
+        std::string pattern,
+        std::size_t const maxPending
+)
+        : mPattern{std::move(pattern)}
+        , mMaxPending{std::max<std::size_t>(maxPending, 1)}
+        , mWorker{&FrameWriter::work, this}
+{
+}
+
+FrameWriter::~FrameWriter()
+{
+    {
+        std::lock_guard lock{mMutex};
+        mStopping = true;
+    }
+    mChanged.notify_all();
+    mWorker.join();
+}
+
+void
+FrameWriter::write(
+        Canvas const &canvas
+)
+{
+    TRACE_ZONE("FrameWriter::write");
+    std::unique_lock lock{mMutex};
+    mChanged.wait(lock, [&] {
+        return mPending.size() < mMaxPending || mError;
+    });
+    rethrow();
+
+    Frame frame{mFrames++, canvas.width(), canvas.height(), canvas.channels(), {}};
+    if (!mRecycled.empty())
+    {
+        frame.pixels = std::move(mRecycled.back());
+        mRecycled.pop_back();
+    }
+
+    // Copying is done under lock, but is far cheaper than encoding and writing the file:
+    auto const pixels = canvas.pixels();
+    frame.pixels.assign(pixels.begin(), pixels.end());
+
+    mPending.push_back(std::move(frame));
+    lock.unlock();
+    mChanged.notify_all();
+}
+
+void
+FrameWriter::flush()
+{
+    std::unique_lock lock{mMutex};
+    mChanged.wait(lock, [&] {
+        return (mPending.empty() && !mWriting) || mError;
+    });
+    rethrow();
+}
+
+std::size_t
+FrameWriter::frames() const
+{
+    std::lock_guard lock{mMutex};
+    return mFrames;
+}
+
+void
+FrameWriter::work()
+{
+    std::unique_lock lock{mMutex};
+    while (true)
+    {
+        mChanged.wait(lock, [&] {
+            return !mPending.empty() || mStopping;
+        });
+
+        if (mPending.empty())
+        {
+            // Stopping, and nothing left to write:
+            return;
+        }
+
+        Frame frame = std::move(mPending.front());
+        mPending.pop_front();
+        mWriting = true;
+        lock.unlock();
+        mChanged.notify_all();
+
+        std::exception_ptr error;
+        try
+        {
+            writeFile(frame);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        mWriting = false;
+        mRecycled.push_back(std::move(frame.pixels));
+        if (error && !mError)
+        {
+            mError = error;
+        }
+        mChanged.notify_all();
+    }
+}
+
+void
+FrameWriter::writeFile(
+        Frame const &frame
+) const
+{
+    TRACE_ZONE("FrameWriter::writeFile");
+    bool const gray = Canvas::Channels::Gray == frame.channels;
+    std::string const path = fmt::format(mPattern, frame.index) + (gray ? ".pgm" : ".ppm");
+
+    std::ofstream file{path, std::ios::binary};
+    if (!file)
+    {
+        throw std::runtime_error{"cannot open frame file " + path};
+    }
+
+    // Binary Netpbm format: P5 is grayscale, P6 is RGB, both with 8 bit per channel:
+    file << (gray ? "P5" : "P6") << '\n' << frame.width << ' ' << frame.height << "\n255\n";
+    file.write(reinterpret_cast<char const *>(frame.pixels.data()), frame.pixels.size());
+
+    if (!file)
+    {
+        throw std::runtime_error{"cannot write frame file " + path};
+    }
+}
+
+void
+FrameWriter::rethrow()
+{
+    if (mError)
+    {
+        std::rethrow_exception(std::exchange(mError, nullptr));
+    }
+}
@@ -0,0 +1,116 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Canvas.h"
+
+/**
+ * Writes a sequence of canvas frames as binary PGM (grayscale) or PPM (RGB) image files.
+ * Encoding and disk I/O happen on a background thread, so rendering the next frame overlaps with writing the previous
+ * ones. Pixel buffers are recycled, so no allocations happen once the queue has been filled.
+ */
+class FrameWriter
+{
+
+public:
+
+    /**
+     * Create a writer and start its background thread.
+     * @param pattern File name pattern, formatted with the frame index, e.g. `"frames/orbit-{:05}"`. The extension
+     * `.pgm` or `.ppm` is appended according to the canvas' channels.
+     * @param maxPending Maximum count of frames waiting to be written. `write()` blocks if exceeded.
+     */
+    explicit FrameWriter(
+            std::string pattern,
+            std::size_t maxPending = 4
+    );
+
+    /**
+     * Write all pending frames, and stop the background thread.
+     */
+    ~FrameWriter();
+
+    FrameWriter(FrameWriter const &) = delete;
+
+    FrameWriter &
+    operator=(FrameWriter const &) = delete;
+
+    /**
+     * Copy a canvas' content into the queue of frames to write.
+     * @param canvas Canvas to write.
+     * @throw If writing any previous frame failed.
+     */
+    void
+    write(
+            Canvas const &canvas
+    );
+
+    /**
+     * Block until all pending frames are written.
+     * @throw If writing any frame failed.
+     */
+    void
+    flush();
+
+    /**
+     * @return Count of frames passed to `write()` so far.
+     */
+    std::size_t
+    frames() const;
+
+private:
+
+    struct Frame
+    {
+        std::size_t index;
+        std::size_t width;
+        std::size_t height;
+        Canvas::Channels channels;
+        std::vector<std::uint8_t> pixels;
+    };
+
+    std::string mPattern;
+    std::size_t mMaxPending;
+    std::size_t mFrames{0};
+
+    mutable std::mutex mMutex;
+    std::condition_variable mChanged;
+    std::deque<Frame> mPending;     ///< Frames waiting to be written
+    std::vector<std::vector<std::uint8_t>> mRecycled; ///< Pixel buffers of written frames, ready for reuse
+    bool mWriting{false};           ///< Background thread is currently writing a frame
+    bool mStopping{false};
+    std::exception_ptr mError;
+
+    std::thread mWorker;
+
+    /**
+     * Background thread loop.
+     */
+    void
+    work();
+
+    /**
+     * Encode and write a single frame to disk.
+     * @param frame Frame to write.
+     */
+    void
+    writeFile(
+            Frame const &frame
+    ) const;
+
+    /**
+     * Rethrow an error from the background thread, if any. Must be called with the mutex locked.
+     */
+    void
+    rethrow();
+
+};
@@ -3,14 +3,16 @@
 //
 
 #include "Graphics.h"
-#include <glm/gtx/matrix_transform_2d.hpp>
 #include <orbital/math/elementary.h>
 #include <orbital/common/convert.h>
+#include <orbital/common/trace.h>
 
 Graphics::Graphics(
         size_t const rows,
-        size_t cols
+        size_t cols,
+        Raster const raster
 )
+        : mRaster{raster}
 {
     if (0 == rows)
     {
@@ -22,6 +24,13 @@ Graphics::Graphics(
         cols = static_cast<size_t>(rows / charRatio());
     }
 
+    if (Raster::Braille == mRaster)
+    {
+        mCellWidth = 2;
+        mCellHeight = 4;
+        mDots.resize(rows * cols);
+    }
+
     mScanlines.resize(rows);
     for (auto &scanline : mScanlines)
     {
@@ -29,29 +38,34 @@ Graphics::Graphics(
     }
     clear();
 
+    // Framebuffer pixel width to height ratio:
+    Decimal const pixelRatio = charRatio() * mCellHeight / mCellWidth;
+
     // Span over whole viewport
-    mProjection = glm::scale(mat{1}, {cols / 2.0, rows / 2.0});
+    Transform<Decimal> projection;
+    projection.scale({width() / 2.0, height() / 2.0});
 
     // Origin should sit in the center
-    mProjection = glm::translate(mProjection, {1, 1});
+    projection.translate({1, 1});
 
     // Y-Axis should point upwards
-    mProjection = glm::scale(mProjection, {1, -1});
+    projection.scale({1, -1});
 
     // Scale against viewport distort
-    mProjection = glm::scale(mProjection, {rows / static_cast<Decimal>(cols) / charRatio(), 1});
+    projection.scale({height() / static_cast<Decimal>(width()) / pixelRatio, 1});
 
-    push();
-    updateTransform();
+    project(projection);
 }
 
 void
 Graphics::clear()
 {
+    TRACE_ZONE("Graphics::clear");
     for (auto &scanline : mScanlines)
     {
         std::fill(scanline.begin(), scanline.end(), ' ');
     }
+    std::fill(mDots.begin(), mDots.end(), 0);
 }
 
 void
@@ -66,10 +80,114 @@ Graphics::pixel(
         return;
     }
 
-    char &target = framebufferPixel(FramebufferLocation{vec});
-    if (mOverwrite || (!mOverwrite && ' ' == target))
+    FramebufferLocation const loc{vec};
+    plot(loc.x, loc.y, c);
+}
+
+void
+Graphics::points(
+        Span<vec const> const worldVectors,
+        char const c
+)
+{
+    TRACE_ZONE("Graphics::points");
+    LocationChunk locations;
+
+    for (std::size_t offset = 0; offset < worldVectors.size(); offset += LocationChunk::size)
     {
-        target = c;
+        auto const chunk = worldVectors.subspan(offset, LocationChunk::size);
+        mapToLocations(chunk, locations);
+
+        for (std::size_t i = 0; i < chunk.size(); i++)
+        {
+            // Bounds have been checked by mapToLocations() already:
+            if (LocationChunk::culled != locations.ys[i])
+            {
+                plot(locations.xs[i], locations.ys[i], c);
+            }
+        }
+    }
+}
+
+void
+Graphics::density(
+        Span<vec const> const worldVectors,
+        DensityScale const scale,
+        std::size_t const threads
+)
+{
+    TRACE_ZONE("Graphics::density");
+    std::size_t const cols = columns();
+    std::size_t const chunks = threadCount(worldVectors.size(), minimumDensityPointsPerThread(), threads);
+
+    // Each thread bins its share of positions into its own histogram, so no synchronization is needed. Histograms are
+    // kept across frames, and only grow when the viewport or count of threads does:
+    std::size_t const cells = rows() * cols;
+    if (mHistograms.size() < chunks * cells)
+    {
+        mHistograms.resize(chunks * cells);
+    }
+    std::fill(mHistograms.begin(), mHistograms.begin() + chunks * cells, 0);
+    parallelChunks(mWorkers, worldVectors.size(), chunks, [&](
+            std::size_t const begin,
+            std::size_t const end,
+            std::size_t const thread
+    ) {
+        std::uint32_t *const histogram = mHistograms.data() + thread * cells;
+        LocationChunk locations;
+        for (std::size_t offset = begin; offset < end; offset += LocationChunk::size)
+        {
+            auto const chunk = worldVectors.subspan(offset, std::min(LocationChunk::size, end - offset));
+            mapToLocations(chunk, locations);
+            for (std::size_t i = 0; i < chunk.size(); i++)
+            {
+                if (LocationChunk::culled != locations.ys[i])
+                {
+                    histogram[locations.ys[i] / mCellHeight * cols + locations.xs[i] / mCellWidth]++;
+                }
+            }
+        }
+    });
+
+    // Merge all histograms into the first one:
+    std::uint32_t *const histogram = mHistograms.data();
+    for (std::size_t chunk = 1; chunk < chunks; chunk++)
+    {
+        std::uint32_t const *const other = mHistograms.data() + chunk * cells;
+        std::transform(histogram, histogram + cells, other, histogram, std::plus<>{});
+    }
+
+    std::uint32_t const maximum = *std::max_element(histogram, histogram + cells);
+    if (0 == maximum)
+    {
+        return;
+    }
+
+    auto const ramp = densityRamp();
+    auto const levels = static_cast<Decimal>(ramp.size() - 1);
+    Decimal const normalization = DensityScale::Logarithmic == scale ? std::log1p(maximum) : maximum;
+
+    for (std::size_t cell = 0; cell < cells; cell++)
+    {
+        std::uint32_t const count = histogram[cell];
+        if (0 == count)
+        {
+            continue;
+        }
+
+        Decimal const level = (DensityScale::Logarithmic == scale ? std::log1p(count) : count) / normalization;
+
+        // Any non-empty cell gets at least the first non-blank character:
+        auto const index = std::clamp<std::size_t>(static_cast<std::size_t>(std::ceil(level * levels)), 1,
+                ramp.size() - 1);
+
+        char &target = mScanlines[cell / cols][cell % cols];
+        if (mOverwrite || ' ' == target)
+        {
+            mPixelTally++;
+            mOverdrawTally += ' ' != target;
+            target = ramp[index];
+        }
     }
 }
 
@@ -85,7 +203,10 @@ Graphics::label(
         return;
     }
 
+    // Text is always placed into whole cells:
     FramebufferLocation loc{vec};
+    loc.x /= mCellWidth;
+    loc.y /= mCellHeight;
 
     // If text length exceeds scanline length from a given column,
     // the text must be trimmed to a smaller size to avoid:
@@ -98,9 +219,9 @@ Graphics::label(
     }
     else
     {
-        for (int i = 0; i < span; i++)
+        for (std::size_t i = 0; i < span; i++)
         {
-            char &target = framebufferPixel(loc);
+            char &target = framebufferPixel({loc.x + i, loc.y});
             if (' ' == target)
             {
                 target = text[i];
@@ -109,20 +230,59 @@ Graphics::label(
     }
 }
 
-FramebufferVector
-Graphics::mapToFramebuffer(
-        WorldVector const &vec
-)
+void
+Graphics::mapToLocations(
+        Span<vec const> const worldVectors,
+        LocationChunk &locations
+) const
 {
-    return mTransform * vec3{vec, 1.0};
+    assert(worldVectors.size() <= LocationChunk::size);
+
+    Decimal const m00 = mTransform.xAxis().x;
+    Decimal const m01 = mTransform.xAxis().y;
+    Decimal const m10 = mTransform.yAxis().x;
+    Decimal const m11 = mTransform.yAxis().y;
+    Decimal const tx = mTransform.translation().x;
+    Decimal const ty = mTransform.translation().y;
+
+    auto const w = static_cast<Decimal>(width());
+    auto const h = static_cast<Decimal>(height());
+
+    for (std::size_t i = 0; i < worldVectors.size(); i++)
+    {
+        Decimal const x = m00 * worldVectors[i].x + m10 * worldVectors[i].y + tx;
+        Decimal const y = m01 * worldVectors[i].x + m11 * worldVectors[i].y + ty;
+        bool const inside = (x >= 0) & (x < w) & (y >= 0) & (y < h);
+        locations.ys[i] = inside ? static_cast<std::uint32_t>(y) : LocationChunk::culled;
+        locations.xs[i] = inside ? static_cast<std::uint32_t>(x) : 0;
+    }
 }
 
-Graphics::WorldVector
-Graphics::mapToWorld(
-        FramebufferVector const &vec
+void
+Graphics::plot(
+        std::size_t const x,
+        std::size_t const y,
+        char const c
 )
 {
-    return glm::inverse(mTransform) * vec3{vec, 1.0};
+    if (Raster::Braille == mRaster)
+    {
+        // Braille dots are numbered column-wise, except the bottom-most row, which was added later to the standard:
+        static constexpr std::uint8_t bits[4][2]{{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+        std::uint8_t &dots = mDots[y / 4 * columns() + x / 2];
+        mPixelTally++;
+        mOverdrawTally += 0 != (dots & bits[y % 4][x % 2]);
+        dots |= bits[y % 4][x % 2];
+        return;
+    }
+
+    char &target = mScanlines[y][x];
+    if (mOverwrite || ' ' == target)
+    {
+        mPixelTally++;
+        mOverdrawTally += ' ' != target;
+        target = c;
+    }
 }
 
 void
@@ -142,105 +302,181 @@ Graphics::border()
     mScanlines.back().back() = '+';
 }
 
-void
-Graphics::translate(
-        WorldVector const &v
-)
+std::size_t
+Graphics::columns() const
 {
-    mTransformStack.back().translate(v);
-    updateTransform();
+    return static_cast<int>(mScanlines[0].length());
 }
 
-void
-Graphics::scale(
-        Decimal const s
-)
+std::size_t
+Graphics::width() const
 {
-    mTransformStack.back().scale(s);
-    updateTransform();
+    return columns() * mCellWidth;
+}
+
+std::size_t
+Graphics::height() const
+{
+    return rows() * mCellHeight;
 }
 
 void
-Graphics::rotate(
-        Radian<Decimal> const theta
+Graphics::present(
+        std::ostream &os
 )
 {
-    mTransformStack.back().rotate(theta);
-    updateTransform();
+    TRACE_ZONE("Graphics::present");
+    std::string frame;
+    frame.reserve(rows() * (columns() + 1));
+
+    if (!mDiffing)
+    {
+        for (std::size_t row = 0; row < rows(); row++)
+        {
+            if (Raster::Text == mRaster)
+            {
+                frame += mScanlines[row];
+            }
+            else
+            {
+                for (std::size_t column = 0; column < columns(); column++)
+                {
+                    appendGlyph(frame, glyph(row, column));
+                }
+            }
+            frame += '\n';
+        }
+        os << frame << std::flush;
+        mPresentedByteCounter.add(frame.size());
+        flushTallies();
+        return;
+    }
+
+    if (mPresented.empty())
+    {
+        // Nothing is known about the terminal content yet, clear it and force every cell to be emitted:
+        frame += "\x1b[2J";
+        mPresented.assign(rows() * columns(), std::numeric_limits<Glyph>::max());
+    }
+
+    for (std::size_t row = 0; row < rows(); row++)
+    {
+        std::size_t column = 0;
+        while (column < columns())
+        {
+            // Skip unchanged cells:
+            if (mPresented[row * columns() + column] == glyph(row, column))
+            {
+                column++;
+                continue;
+            }
+
+            // Move cursor to the first changed cell, and emit the whole run of changed cells:
+            frame += fmt::format("\x1b[{};{}H", row + 1, column + 1);
+            for (; column < columns(); column++)
+            {
+                Glyph const current = glyph(row, column);
+                if (mPresented[row * columns() + column] == current)
+                {
+                    break;
+                }
+                appendGlyph(frame, current);
+                mPresented[row * columns() + column] = current;
+            }
+        }
+    }
+
+    // Park cursor below the frame:
+    frame += fmt::format("\x1b[{};1H", rows() + 1);
+    os << frame << std::flush;
+    mPresentedByteCounter.add(frame.size());
+    flushTallies();
 }
 
 void
-Graphics::updateTransform()
+Graphics::hud(
+        std::string_view const text
+)
 {
-    mat view{1};
-    for (auto transform : mTransformStack)
+    if (columns() < 3)
     {
-        view *= transform.transformation();
+        return;
     }
-    mTransform = mProjection * view;
+    auto const span = std::min(text.length(), columns() - 2);
+    std::copy(text.begin(), text.begin() + span, mScanlines.front().begin() + 1);
 }
 
-std::size_t
-Graphics::columns() const
+Metrics &
+Graphics::metrics()
 {
-    return static_cast<int>(mScanlines[0].length());
+    flushTallies();
+    return mMetrics;
 }
 
 void
-Graphics::resetTransform()
+Graphics::flushTallies()
 {
-    mTransformStack.back().reset();
-    updateTransform();
+    mLeafCounter.add(mLeafTally);
+    mPixelCounter.add(mPixelTally);
+    mOverdrawCounter.add(mOverdrawTally);
+    mLeafTally = mPixelTally = mOverdrawTally = 0;
 }
 
-void
-Graphics::present()
+Graphics::Glyph
+Graphics::glyph(
+        std::size_t const row,
+        std::size_t const column
+) const
 {
-    for (auto &scanline : mScanlines)
+    char const c = mScanlines[row][column];
+    if (' ' != c || mDots.empty())
     {
-        std::cout << scanline << '\n';
+        return static_cast<Glyph>(static_cast<unsigned char>(c));
     }
-    std::cout << std::flush;
-}
 
-bool
-Graphics::withinFramebufferBounds(
-        const FramebufferVector &v
-) const
-{
-    return v.y >= 0 && v.y < rows() && v.x >= 0 && v.x < columns();
+    std::uint8_t const dots = mDots[row * columns() + column];
+    return 0 == dots ? Glyph{' '} : static_cast<Glyph>(brailleBase() + dots);
 }
 
 void
-Graphics::push()
+Graphics::appendGlyph(
+        std::string &out,
+        Glyph const glyph
+)
 {
-    mTransformStack.emplace_back();
-}
+    if (glyph < 0x80)
+    {
+        out += static_cast<char>(glyph);
+        return;
+    }
 
-void
-Graphics::pop()
-{
-    mTransformStack.pop_back();
-    updateTransform();
+    // Three byte UTF-8 sequence, sufficient for the whole basic multilingual plane:
+    out += static_cast<char>(0xe0 | (glyph >> 12));
+    out += static_cast<char>(0x80 | ((glyph >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (glyph & 0x3f));
 }
 
-mat const &
-Graphics::transformation()
+bool
+Graphics::withinFramebufferBounds(
+        const FramebufferVector &v
+) const
 {
-    return mTransform;
+    return v.y >= 0 && v.y < height() && v.x >= 0 && v.x < width();
 }
 
 void
 Graphics::ellipse(const Ellipse<Decimal> &ellipse)
 {
+    TRACE_ZONE("Graphics::ellipse");
     // Skip ellipse rendering if the viewport is completely contained by the ellipse shape,
     // i.e. no lines are visible anyway.
-    vec ll = mapToWorld({0, rows() - 1});
-    vec ur = mapToWorld({columns() - 1, 0});
+    vec ll = mapToWorld({0, height() - 1});
+    vec ur = mapToWorld({width() - 1, 0});
     if (ellipse.contains(Rectangle<Decimal>{ll, ur}))
     {
         return;
     }
+    mEllipseCounter.add();
 
     // Since the stepper calculates the pixel distance based on vector subtraction and *not* on ellipse arc length,
     // the ellipse must be divided into 4 quarters
@@ -258,8 +494,8 @@ Graphics::stepper(
 )
 {
     // Calculate distance the painted pixels of the start and end arc would have within the framebuffer:
-    auto const vs = convert<WorldVector>(ellipse.point(ts));
-    auto const ve = convert<WorldVector>(ellipse.point(te));
+    auto const vs = convert<WorldVector>(ellipse.point<FastTrig>(ts));
+    auto const ve = convert<WorldVector>(ellipse.point<FastTrig>(te));
     Decimal const d = vectorDistance(mapToFramebuffer(ve), mapToFramebuffer(vs));
 
     // 1.4142... is the distance between to diagonal pixels:
@@ -275,6 +511,7 @@ Graphics::stepper(
     else
     {
         // Paint pixel:
+        mLeafTally++;
         pixel(vs, '+');
     }
 }
@@ -287,6 +524,15 @@ Graphics::overwrite(
     mOverwrite = b;
 }
 
+void
+Graphics::diffing(
+        bool const b
+)
+{
+    mDiffing = b;
+    mPresented.clear();
+}
+
 std::size_t
 Graphics::rows() const
 {
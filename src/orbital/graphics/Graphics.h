@@ -2,33 +2,60 @@
 // Created by jim on 24.01.18.
 //
 
-#include <list>
 #include <orbital/common/common.h>
+#include <orbital/common/Metrics.h>
+#include <orbital/common/parallel.h>
+#include <orbital/common/Span.h>
 #include <orbital/math/Ellipse.h>
-#include <orbital/math/Transform.h>
 #include <string>
 #include <string_view>
 #include <vector>
 #include "FramebufferVector.h"
 #include "FramebufferLocation.h"
+#include "TransformStack.h"
 
 #pragma once
 
 /**
  * Paints text graphics into a framebuffer.
  * Provides a transformation stack, whereas the final transform matrix is built bottom-to-top.
+ *
+ * The framebuffer is rastered either by one pixel per character cell, or by 2x4 pixels per cell, which are presented
+ * as Unicode braille glyphs. Text, i.e. labels and borders, is always placed into whole cells and hides any braille
+ * pixels of that cell.
  */
 class Graphics
+        : public TransformStack
 {
 
 public:
 
-    struct WorldVector
-            : public vec
+    /**
+     * Rasterization of the framebuffer.
+     */
+    enum class Raster
+    {
+        Text,   ///< One pixel per character cell, painted with the requested character
+        Braille ///< 2x4 pixels per character cell, painted as braille dots
+    };
+
+    /**
+     * Scaling applied to cell counts by `density()`.
+     */
+    enum class DensityScale
     {
-        using vec::vec;
+        Linear,
+        Logarithmic
     };
 
+    /**
+     * @return Minimum count of positions a thread bins in `density()`, to be worth handing them to a worker.
+     */
+    static constexpr std::size_t
+    minimumDensityPointsPerThread()
+    {
+        return 1 << 16;
+    }
 
     /**
      * Character width to height ration.
@@ -39,15 +66,26 @@ public:
         return 1 / 2.0;
     }
 
+    /**
+     * Characters used by `density()`, ordered by increasing density. The first character denotes an empty cell.
+     */
+    static constexpr std::string_view
+    densityRamp()
+    {
+        return " .:-=+*#%@"sv;
+    }
+
     /**
      * Create a new graphics with a given count of rows and columns.
      * Pushes an initial layer of transformation.
      * @param rows Count of rows.
      * @param cols Count of columns.
+     * @param raster Rasterization of the framebuffer.
      */
     explicit Graphics(
             size_t rows = 21,
-            size_t cols = 0
+            size_t cols = 0,
+            Raster raster = Raster::Text
     );
 
     /**
@@ -68,14 +106,14 @@ public:
     );
 
     /**
-     * Map framebuffer coordinates to transform space coordinates, i.e. the transformed coordinated which would map
-     * to this framebuffer coordinate.
-     * @param vec Framebuffer coordinate
-     * @return Mapped to transformed space.
+     * Set the dirty-cell diffing bit.
+     * If set, `present()` expects a terminal supporting ANSI escape sequences, and only emits cells which changed since
+     * the previously presented frame, instead of all scanlines.
+     * @param b Diffing enable bit.
      */
-    WorldVector
-    mapToWorld(
-            FramebufferVector const &vec
+    void
+    diffing(
+            bool b
     );
 
     /**
@@ -92,7 +130,7 @@ public:
     /**
      * Write a single character to a position.
      * @param worldVector Untransformed position.
-     * @param c Character to write.
+     * @param c Character to write. Ignored when rastering braille, which only sets a dot.
      */
     void
     pixel(
@@ -100,6 +138,36 @@ public:
             char const c
     );
 
+    /**
+     * Write a character to many positions at once.
+     * Transforms, culls and writes the whole array in one pass, which is by far cheaper than calling `pixel()` for
+     * each position. Positions mapping outside the framebuffer are silently skipped.
+     * @param worldVectors Untransformed positions.
+     * @param c Character to write. Ignored when rastering braille, which only sets a dot.
+     */
+    void
+    points(
+            Span<vec const> worldVectors,
+            char c
+    );
+
+    /**
+     * Draw a density map of many positions.
+     * Counts the positions falling into each framebuffer cell and writes a character from `densityRamp()` into each
+     * non-empty cell, chosen by the cell's count relative to the maximum count. Density maps are always written as
+     * text, regardless of the raster. Large arrays are binned in parallel,
+     * using one histogram per thread, which are merged afterwards.
+     * @param worldVectors Untransformed positions.
+     * @param scale Scaling of counts. Logarithmic scaling keeps sparse cells visible next to very dense ones.
+     * @param threads Maximum count of threads. 0 means as many as there are hardware threads.
+     */
+    void
+    density(
+            Span<vec const> worldVectors,
+            DensityScale scale = DensityScale::Linear,
+            std::size_t threads = 0
+    );
+
     /**
      * Draw an ellipse.
      * @param ellipse Ellipse to draw.
@@ -110,103 +178,120 @@ public:
     );
 
     /**
-     * Add a new layer of transformation, being marked as the current one.
+     * Draws a border at the framebuffer edges.
+     * Ignores the overwrite bit.
      */
     void
-    push();
+    border();
 
     /**
-     * Remove the top-most transform layer, if any.
-     * Marks the second top-most layer as the current transform layer.
+     * @return Count of framebuffer columns.
      */
-    void
-    pop();
+    std::size_t
+    columns() const;
 
     /**
-     * Reset any transform of the current layer.
+     * @return Count of framebuffer rows.
      */
-    void
-    resetTransform();
+    std::size_t
+    rows() const;
 
     /**
-     * Add translation to the current transform.
-     * @param v Translation vector.
+     * @return Count of framebuffer pixels horizontally, which is a multiple of the count of columns.
      */
-    void
-    translate(
-            WorldVector const &v
-    );
+    std::size_t
+    width() const;
 
     /**
-     * Add scale to the current transform.
-     * @param s Scale amount.
+     * @return Count of framebuffer pixels vertically, which is a multiple of the count of rows.
      */
-    void
-    scale(
-            Decimal s
-    );
+    std::size_t
+    height() const;
 
     /**
-     * Add rotation to the current transform.
-     * @param theta Amount of rotation, in Radians.
+     * Write a line of text into the top row of the framebuffer, inside the border, e.g. to show metrics as heads-up
+     * display. Always overwrites, and is trimmed to the framebuffer width.
+     * @param text Text to write.
      */
     void
-    rotate(
-            Radian<Decimal> theta
+    hud(
+            std::string_view text
     );
 
     /**
-     * Draws a border at the framebuffer edges.
-     * Ignores the overwrite bit.
+     * Counters of rendering work done:
+     * - `ellipses`: Ellipses drawn, not counting those culled entirely
+     * - `stepper-leaves`: Arcs short enough to be painted as a single pixel by the ellipse stepper
+     * - `pixels`: Pixels written, including cells written by `density()`
+     * - `overdraw`: Pixels written which were not blank already
+     * - `present-bytes`: Bytes emitted by `present()`
+     * @return Metrics registry.
      */
-    void
-    border();
+    Metrics &
+    metrics();
 
     /**
-     * @return Count of framebuffer columns.
+     * Print framebuffer to the console.
+     * The whole frame is composed first and then written at once.
+     * @param os Stream to print to.
      */
-    std::size_t
-    columns() const;
+    void
+    present(
+            std::ostream &os = std::cout
+    );
+
+private:
 
     /**
-     * @return Count of framebuffer rows.
+     * Framebuffer pixels of a chunk of positions, as computed by `mapToLocations()`.
      */
-    std::size_t
-    rows() const;
+    struct LocationChunk
+    {
+        static constexpr std::size_t size = 256;
+        static constexpr std::uint32_t culled = std::numeric_limits<std::uint32_t>::max();
+
+        std::array<std::uint32_t, size> ys; ///< Pixel row of each position, or `culled` if outside of framebuffer
+        std::array<std::uint32_t, size> xs; ///< Pixel column of each position
+    };
 
     /**
-     * Print framebuffer to the console.
+     * Glyph of a presented cell: Either an ASCII character, or a code point within the braille block.
      */
-    void
-    present();
+    using Glyph = std::uint16_t;
 
     /**
-     * @return Total transform, including of the whole transformation stack, i.e. considering all layers.
+     * First code point of the Unicode braille block, i.e. the empty braille glyph.
      */
-    mat const &
-    transformation();
+    static constexpr Glyph
+    brailleBase()
+    {
+        return 0x2800;
+    }
 
-private:
+    /**
+     * Overwrite content in framebuffer flag.
+     */
+    bool mOverwrite{true};
 
     /**
-     * Stack of transformations.
+     * Dirty-cell diffing flag.
      */
-    std::list<Transform<Decimal>> mTransformStack;
+    bool mDiffing{false};
 
     /**
-     * Projection matrix, calculated once.
+     * Rasterization of the framebuffer.
      */
-    mat mProjection;
+    Raster mRaster;
 
     /**
-     * Total transform, update every time the transform stack is modified.
+     * Framebuffer pixels per character cell, horizontally.
      */
-    mat mTransform;
+    std::size_t mCellWidth{1};
 
     /**
-     * Overwrite content in framebuffer flag.
+     * Framebuffer pixels per character cell, vertically.
      */
-    bool mOverwrite;
+    std::size_t mCellHeight{1};
 
     /**
      * Row major scan-line framebuffer
@@ -214,20 +299,97 @@ private:
     std::vector<std::string> mScanlines;
 
     /**
-     * Maps an untransformed vector to the framebuffer coordinate space.
-     * @param vec Vector to map.
-     * @return Location within framebuffer.
+     * Row major braille dot masks, one per cell. Only used if rastering braille.
      */
-    FramebufferVector
-    mapToFramebuffer(
-            WorldVector const &vec
-    );
+    std::vector<std::uint8_t> mDots;
 
     /**
-     * Recalculates the total transform.
+     * Glyphs of the previously presented frame, used for dirty-cell diffing. Empty if nothing was presented yet.
+     */
+    std::vector<Glyph> mPresented;
+
+    /**
+     * Cell counts of each thread binning positions in `density()`, one after the other. Kept across frames.
+     */
+    std::vector<std::uint32_t> mHistograms;
+
+    /**
+     * Threads binning positions in `density()`, kept across frames.
+     */
+    WorkerPool mWorkers;
+
+    /**
+     * Rendering metrics, see `metrics()`.
+     */
+    Metrics mMetrics;
+    Counter &mEllipseCounter = mMetrics.counter("ellipses");
+    Counter &mLeafCounter = mMetrics.counter("stepper-leaves");
+    Counter &mPixelCounter = mMetrics.counter("pixels");
+    Counter &mOverdrawCounter = mMetrics.counter("overdraw");
+    Counter &mPresentedByteCounter = mMetrics.counter("present-bytes");
+
+    /**
+     * Work done since the tallies were last added to the counters.
+     * Plain members keep per-pixel counting cheap, they are added to the counters once per frame.
+     */
+    std::uint64_t mLeafTally{0};
+    std::uint64_t mPixelTally{0};
+    std::uint64_t mOverdrawTally{0};
+
+    /**
+     * Add the tallies to their counters, and reset them.
+     */
+    void
+    flushTallies();
+
+    /**
+     * Maps a chunk of untransformed vectors to framebuffer pixels.
+     * Does only arithmetic, and is therefore vectorizable.
+     * @param worldVectors Vectors to map, at most `LocationChunk::size`.
+     * @param locations Receives the pixel of each vector.
+     */
+    void
+    mapToLocations(
+            Span<vec const> worldVectors,
+            LocationChunk &locations
+    ) const;
+
+    /**
+     * Paint a single framebuffer pixel, according to the raster and the overwrite bit.
+     * @attention No bounds checking is performed.
+     * @param x Pixel column.
+     * @param y Pixel row.
+     * @param c Character to write if rastering text.
      */
     void
-    updateTransform();
+    plot(
+            std::size_t x,
+            std::size_t y,
+            char c
+    );
+
+    /**
+     * Compute the glyph to present for a cell: Text hides braille dots.
+     * @param row Cell row.
+     * @param column Cell column.
+     * @return Glyph.
+     */
+    Glyph
+    glyph(
+            std::size_t row,
+            std::size_t column
+    ) const;
+
+    /**
+     * Append a glyph as UTF-8 to a string.
+     * @param out String to append to.
+     * @param glyph Glyph to append.
+     */
+    static void
+    appendGlyph(
+            std::string &out,
+            Glyph glyph
+    );
 
     /**
      * @param v Location to check for.
@@ -240,6 +402,7 @@ private:
 
     /**
      * Internal function, used to render ellipses.
+     * Evaluates points with `FastTrig`, whose error is far below a pixel.
      * @param ellipse Ellipse to render.
      * @param ts Start ellipse parameter.
      * @param te End ellipse parameter.
@@ -252,8 +415,8 @@ private:
     );
 
     /**
-     * Give a reference to a pixel within the framebuffer.
-     * @param loc Target location of pixel.
+     * Give a reference to a character cell within the framebuffer.
+     * @param loc Target location of cell.
      * @return Reference.
      */
     char &
@@ -262,8 +425,8 @@ private:
     );
 
     /**
-     * Give a const reference to a pixel within the framebuffer.
-     * @param loc Target location of pixel.
+     * Give a const reference to a character cell within the framebuffer.
+     * @param loc Target location of cell.
      * @return Const reference.
      */
     const char &
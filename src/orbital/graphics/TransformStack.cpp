@@ -0,0 +1,101 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "TransformStack.h"
+#include <orbital/common/convert.h>
+
+TransformStack::TransformStack()
+{
+    push();
+    updateTransform();
+}
+
+void
+TransformStack::project(
+        Transform<Decimal> const &projection
+)
+{
+    mProjection = projection;
+    updateTransform();
+}
+
+FramebufferVector
+TransformStack::mapToFramebuffer(
+        WorldVector const &vec
+) const
+{
+    return convert<FramebufferVector>(mTransform.applied(vec));
+}
+
+TransformStack::WorldVector
+TransformStack::mapToWorld(
+        FramebufferVector const &vec
+)
+{
+    return convert<WorldVector>(mTransform.inverse().applied(vec));
+}
+
+void
+TransformStack::translate(
+        WorldVector const &v
+)
+{
+    mTransformStack.back().translate(v);
+    updateTransform();
+}
+
+void
+TransformStack::scale(
+        Decimal const s
+)
+{
+    mTransformStack.back().scale(s);
+    updateTransform();
+}
+
+void
+TransformStack::rotate(
+        Radian<Decimal> const theta
+)
+{
+    mTransformStack.back().rotate(theta);
+    updateTransform();
+}
+
+void
+TransformStack::updateTransform()
+{
+    Transform<Decimal> view;
+    for (auto const &transform : mTransformStack)
+    {
+        view *= transform;
+    }
+    mTransform = mProjection * view;
+}
+
+void
+TransformStack::resetTransform()
+{
+    mTransformStack.back().reset();
+    updateTransform();
+}
+
+void
+TransformStack::push()
+{
+    mTransformStack.emplace_back();
+}
+
+void
+TransformStack::pop()
+{
+    mTransformStack.pop_back();
+    updateTransform();
+}
+
+Transform<Decimal> const &
+TransformStack::transformation()
+{
+    return mTransform;
+}
@@ -0,0 +1,141 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <list>
+#include <orbital/common/common.h>
+#include <orbital/math/Radian.h>
+#include <orbital/math/Transform.h>
+#include "FramebufferVector.h"
+
+/**
+ * Stack of transformations, mapping world coordinates into the framebuffer space of a render target.
+ * The final transform is built bottom-to-top, and a projection, set by the render target, is applied last.
+ */
+class TransformStack
+{
+
+public:
+
+    struct WorldVector
+            : public vec
+    {
+        using vec::vec;
+    };
+
+    /**
+     * Map framebuffer coordinates to transform space coordinates, i.e. the transformed coordinated which would map
+     * to this framebuffer coordinate.
+     * @param vec Framebuffer coordinate
+     * @return Mapped to transformed space.
+     */
+    WorldVector
+    mapToWorld(
+            FramebufferVector const &vec
+    );
+
+    /**
+     * Add a new layer of transformation, being marked as the current one.
+     */
+    void
+    push();
+
+    /**
+     * Remove the top-most transform layer, if any.
+     * Marks the second top-most layer as the current transform layer.
+     */
+    void
+    pop();
+
+    /**
+     * Reset any transform of the current layer.
+     */
+    void
+    resetTransform();
+
+    /**
+     * Add translation to the current transform.
+     * @param v Translation vector.
+     */
+    void
+    translate(
+            WorldVector const &v
+    );
+
+    /**
+     * Add scale to the current transform.
+     * @param s Scale amount.
+     */
+    void
+    scale(
+            Decimal s
+    );
+
+    /**
+     * Add rotation to the current transform.
+     * @param theta Amount of rotation, in Radians.
+     */
+    void
+    rotate(
+            Radian<Decimal> theta
+    );
+
+    /**
+     * @return Total transform, including of the whole transformation stack, i.e. considering all layers.
+     */
+    Transform<Decimal> const &
+    transformation();
+
+protected:
+
+    /**
+     * Create a stack with an initial layer of transformation, and an identity projection.
+     */
+    TransformStack();
+
+    /**
+     * Set the projection, mapping the result of the transform stack to framebuffer space.
+     * Intended to be called once by render targets, after their framebuffer extent is known.
+     * @param projection Projection transform.
+     */
+    void
+    project(
+            Transform<Decimal> const &projection
+    );
+
+    /**
+     * Maps an untransformed vector to the framebuffer coordinate space.
+     * @param vec Vector to map.
+     * @return Location within framebuffer.
+     */
+    FramebufferVector
+    mapToFramebuffer(
+            WorldVector const &vec
+    ) const;
+
+    /**
+     * Total transform, update every time the transform stack is modified.
+     */
+    Transform<Decimal> mTransform;
+
+private:
+
+    /**
+     * Stack of transformations.
+     */
+    std::list<Transform<Decimal>> mTransformStack;
+
+    /**
+     * Projection, calculated once.
+     */
+    Transform<Decimal> mProjection;
+
+    /**
+     * Recalculates the total transform.
+     */
+    void
+    updateTransform();
+
+};
@@ -0,0 +1,69 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cmath>
+
+/**
+ * Sum of many values, compensating for rounding errors by Neumaier's variant of Kahan summation.
+ *
+ * The rounding error of each addition is accumulated separately, and added to the sum when reading it. So the result
+ * is exact to working precision, unless the values cancel by more digits than the type holds, and does not depend on
+ * whether large or small values come first.
+ *
+ * @attention Compile without `-ffast-math`, which allows optimizing the compensation away.
+ */
+template<class T>
+class CompensatedSum
+{
+
+public:
+
+    /**
+     * Add a value.
+     * @param value Value to add.
+     * @return This sum.
+     */
+    CompensatedSum &
+    operator+=(
+            T const value
+    )
+    {
+        T const sum = mSum + value;
+        mCompensation += std::abs(mSum) >= std::abs(value) ? (mSum - sum) + value : (value - sum) + mSum;
+        mSum = sum;
+        return *this;
+    }
+
+    /**
+     * Add another sum, e.g. to reduce partial sums of several threads.
+     * @param other Sum to add.
+     * @return This sum.
+     */
+    CompensatedSum &
+    operator+=(
+            CompensatedSum const &other
+    )
+    {
+        *this += other.mSum;
+        mCompensation += other.mCompensation;
+        return *this;
+    }
+
+    /**
+     * @return Compensated sum.
+     */
+    T
+    value() const
+    {
+        return mSum + mCompensation;
+    }
+
+private:
+
+    T mSum{0};
+    T mCompensation{0};     ///< Accumulated rounding errors of mSum
+
+};
@@ -8,11 +8,15 @@
 #include "Transform.h"
 #include "elementary.h"
 #include <orbital/common/common.h>
+#include <boost/math/special_functions/ellint_2.hpp>
 
 #pragma once
 
 /**
  * Immutable ellipse, provides math.
+ *
+ * Members are not declared const, so ellipses can be assigned, and containers of them reordered and copied bytewise.
+ * Immutability is kept by the API, which offers no mutators. Trivially copyable and standard layout.
  */
 template<class T>
 class Ellipse
@@ -32,8 +36,8 @@ public:
             T const e
     )
         : mA{a}
-        , mE{e}
         , mB{a * std::sqrt(1 - sq(e))}
+        , mE{e}
         , mFoci{a * e}
     {
     }
@@ -93,15 +97,18 @@ public:
      *         b \cdot sin(t)
      *     \end{pmatrix}
      * \f$
+     * @tparam TTrig Trigonometry policy, see `Radian::sincos()`.
      * @param t Parameter.
      * @return Point on ellipse.
      */
+    template<class TTrig = PreciseTrig>
     tvec<T>
     point(
             Radian<T> const t
     ) const
     {
-        return {mA * t.cos(), mB * t.sin()};
+        auto const [sin, cos] = t.template sincos<TTrig>();
+        return {mA * cos, mB * sin};
     }
 
     /**
@@ -121,8 +128,9 @@ public:
             Radian<T> const theta
     ) const
     {
-        T denominator = std::sqrt(sq(mB * theta.cos()) + sq(mA * theta.sin())) / mA / mB;
-        return {theta.cos() / denominator, theta.sin() / denominator};
+        auto const [sin, cos] = theta.sincos();
+        T denominator = std::sqrt(sq(mB * cos) + sq(mA * sin)) / mA / mB;
+        return {cos / denominator, sin / denominator};
     }
 
     /**
@@ -216,25 +224,32 @@ public:
             }
         };
 
+        // Transform all corners at once:
+        tvec<T> const bottomLeft = transform.applied(rect.bottomLeft());
+        tvec<T> const topLeft = transform.applied(rect.topLeft());
+        tvec<T> const bottomRight = transform.applied(rect.bottomRight());
+        tvec<T> const topRight = transform.applied(rect.topRight());
+
         // Append intersections from line: bottom left - top left
-        storeIntersections(Line<T>{transform.applied(rect.bottomLeft()), transform.applied(rect.topLeft())});
+        storeIntersections(Line<T>{bottomLeft, topLeft});
 
         // Append intersections from line: bottom left - bottom right
-        storeIntersections(Line<T>{transform.applied(rect.bottomLeft()), transform.applied(rect.bottomRight())});
+        storeIntersections(Line<T>{bottomLeft, bottomRight});
 
         // Append intersections from line: top right - top left
-        storeIntersections(Line<T>{transform.applied(rect.topRight()), transform.applied(rect.topLeft())});
+        storeIntersections(Line<T>{topRight, topLeft});
 
         // Append intersections from line: top right - bottom right
-        storeIntersections(Line<T>{transform.applied(rect.topRight()), transform.applied(rect.bottomRight())});
+        storeIntersections(Line<T>{topRight, bottomRight});
 
         std::sort(points.begin(), points.end());
 
+        Transform<T> const inverse = transform.inverse();
+
         // No intersection ranges:
         if (points.empty())
         {
-            if (rect.containsTransformed(transform.inverse(), {0, 0}) &&
-                    rect.containsTransformed(transform.inverse(), {mA, 0}))
+            if (rect.containsTransformed(inverse, {0, 0}) && rect.containsTransformed(inverse, {mA, 0}))
             {
                 // Complete ellipse is visible, since Rectangle<Decimal> contains both, the coordinate origin and the ellipse's
                 // right-most point:
@@ -247,7 +262,7 @@ public:
             Radian<Decimal> const t = average(points[0], points[1]);
             vec const p = point(t);
 
-            if(rect.containsTransformed(transform.inverse(), p))
+            if(rect.containsTransformed(inverse, p))
             {
                 // points are in-order, simple copy them:
                 for(auto iter = points.begin(); iter != points.end(); iter += 2)
@@ -331,27 +346,39 @@ public:
     }
 
     /**
-     * Calculate the length of an arc slice within `ts` and `te`.
+     * Calculate the length of an arc slice within `ts` and `te`:
+     *
      * \f$
-     * \int_{ts}^{te} \sqrt{ a^2 sin^2 x + b^2 cos^2 x } dx
+     * \int_{t_s}^{t_e} \sqrt{ a^2 sin^2 t + b^2 cos^2 t } dt = a \left( E(\frac{\pi}{2} - t_s, e) - E(\frac{\pi}{2} - t_e, e) \right)
      * \f$
+     *
+     * Substituting \f$ t = \frac{\pi}{2} - \varphi \f$ turns the integrand into
+     * \f$ a \sqrt{ 1 - e^2 sin^2 \varphi } \f$, so the arc length is given in closed form by the incomplete elliptic
+     * integral of the second kind \f$ E(\varphi, e) \f$ with the eccentricity as modulus.
      * @param ts Start parameter of arc.
      * @param te End parameter of arc.
-     * @param resolution The higher the resolution, the more accurate the result.
-     * @return Arc length.
+     * @return Arc length, negative if te is less than ts.
      */
     Radian<T>
     arcLength(
             Radian<T> const ts,
-            Radian<T> const te,
-            T const resolution
+            Radian<T> const te
     ) const
     {
-        T sqA = sq(mA);
-        T sqB = sq(mB);
-        return Radian<T>{integral(ts, te, resolution, [&](Radian<Decimal> const x) {
-            return Radian<T>{std::sqrt(sqA * sq(x.sin()) + sqB * sq(x.cos()))}; // try to omit the Radian{} ctor
-        })};
+        // Double precision is sufficient internally, promoting to long double would be several times slower:
+        auto const policy = boost::math::policies::make_policy(boost::math::policies::promote_double<false>());
+        auto const pi = boost::math::constants::pi<T>();
+
+        // E is periodic apart from a linear term: E(φ + mπ, e) = E(φ, e) + 2m E(e), so reduce to |φ| <= π/2 first:
+        auto const incomplete = [&](T const phi) {
+            T const m = std::round(phi / pi);
+            T const residual = phi - m * pi;
+            return (0 == m ? 0 : 2 * m * boost::math::ellint_2(mE, policy)) +
+                    boost::math::ellint_2(mE, residual, policy);
+        };
+
+        auto const quarter = boost::math::constants::half_pi<T>();
+        return Radian<T>{mA * (incomplete(quarter - ts.getRaw()) - incomplete(quarter - te.getRaw()))};
     }
 
     /**
@@ -468,10 +495,10 @@ public:
 
 private:
 
-    T const mA;
-    T const mB;
-    T const mE;
-    T const mFoci;
+    T mA;
+    T mB;
+    T mE;
+    T mFoci;
 
 };
 
@@ -0,0 +1,337 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <orbital/common/Span.h>
+#include "Ellipse.h"
+
+/**
+ * Many ellipses stored as structure of arrays, operated on all at once.
+ *
+ * Each operation is a single loop over plain arrays without branches or per-element function calls, so the compiler
+ * can vectorize it, and no `focalPoints()` arrays are constructed per element. Results are the same as calling the
+ * scalar `Ellipse` operation for each member.
+ *
+ * Loops only vectorize when built with the `ORBITAL_NATIVE` CMake option, as square roots and trigonometry need
+ * `-fno-math-errno`, and vector rounding and blends need more than the baseline SSE2. Without it, batches are about as
+ * fast as scalar loops, and `contains()` is even slightly slower, as it evaluates all conditions for every point.
+ *
+ * All operations take one input and one output element per member ellipse, in order of addition.
+ */
+template<class T>
+class EllipseBatch
+{
+
+public:
+
+    EllipseBatch() = default;
+
+    /**
+     * Create a batch from scalar ellipses.
+     * @param ellipses Member ellipses.
+     */
+    explicit EllipseBatch(
+            Span<Ellipse<T> const> const ellipses
+    )
+    {
+        reserve(ellipses.size());
+        for (auto const &ellipse : ellipses)
+        {
+            add(ellipse);
+        }
+    }
+
+    /**
+     * Append an ellipse.
+     * @param ellipse Ellipse to append.
+     */
+    void
+    add(
+            Ellipse<T> const &ellipse
+    )
+    {
+        mA.push_back(ellipse.a());
+        mB.push_back(ellipse.b());
+        mE.push_back(ellipse.e());
+        mFoci.push_back(ellipse.foci()[1]);
+    }
+
+    /**
+     * Reserve memory for a count of ellipses.
+     * @param count Count of ellipses.
+     */
+    void
+    reserve(
+            std::size_t const count
+    )
+    {
+        mA.reserve(count);
+        mB.reserve(count);
+        mE.reserve(count);
+        mFoci.reserve(count);
+    }
+
+    /**
+     * Remove all ellipses.
+     */
+    void
+    clear()
+    {
+        mA.clear();
+        mB.clear();
+        mE.clear();
+        mFoci.clear();
+    }
+
+    /**
+     * @return Count of ellipses.
+     */
+    std::size_t
+    size() const
+    {
+        return mA.size();
+    }
+
+    /**
+     * Give a member as scalar ellipse.
+     * @param index Member index.
+     * @return Ellipse.
+     */
+    Ellipse<T>
+    operator[](
+            std::size_t const index
+    ) const
+    {
+        return Ellipse<T>{mA[index], mE[index]};
+    }
+
+    /**
+     * @return Major semi-axis of each member.
+     */
+    Span<T const>
+    a() const
+    {
+        return mA;
+    }
+
+    /**
+     * @return Minor semi-axis of each member.
+     */
+    Span<T const>
+    b() const
+    {
+        return mB;
+    }
+
+    /**
+     * @return Numeric eccentricity of each member.
+     */
+    Span<T const>
+    e() const
+    {
+        return mE;
+    }
+
+    /**
+     * Batched `Ellipse::point()`.
+     * @param t Parameter per member.
+     * @param points Receives the point on each member.
+     */
+    void
+    point(
+            Span<Radian<T> const> const t,
+            Span<tvec<T>> const points
+    ) const
+    {
+        assert(t.size() == size() && points.size() == size());
+        T const *const a = mA.data();
+        T const *const b = mB.data();
+        for (std::size_t i = 0, n = size(); i < n; i++)
+        {
+            auto const [sin, cos] = t[i].sincos();
+            points[i] = {a[i] * cos, b[i] * sin};
+        }
+    }
+
+    /**
+     * Batched `Ellipse::projection()`.
+     * @param vectors Point to project per member.
+     * @param projections Receives the projected point on each member.
+     */
+    void
+    projection(
+            Span<tvec<T> const> const vectors,
+            Span<tvec<T>> const projections
+    ) const
+    {
+        assert(vectors.size() == size() && projections.size() == size());
+        T const *const a = mA.data();
+        T const *const b = mB.data();
+        for (std::size_t i = 0, n = size(); i < n; i++)
+        {
+            T const x = vectors[i].x;
+            T const y = vectors[i].y;
+            T const scale = (a[i] * b[i]) / std::sqrt(sq(a[i]) * sq(y) + sq(b[i]) * sq(x));
+            projections[i].x = x * scale;
+            projections[i].y = y * scale;
+        }
+    }
+
+    /**
+     * Batched `Ellipse::contains()` for points.
+     * @param vectors Point to check per member.
+     * @param contained Receives 1 for each member containing its point, 0 otherwise.
+     */
+    void
+    contains(
+            Span<tvec<T> const> const vectors,
+            Span<std::uint8_t> const contained
+    ) const
+    {
+        assert(vectors.size() == size() && contained.size() == size());
+        T const *const a = mA.data();
+        T const *const b = mB.data();
+        T const *const f = mFoci.data();
+        std::uint8_t *const out = contained.data();
+        for (std::size_t i = 0, n = size(); i < n; i++)
+        {
+            out[i] = containsPoint(a[i], b[i], f[i], vectors[i]);
+        }
+    }
+
+    /**
+     * Batched `Ellipse::contains()` for a rectangle, e.g. to cull orbits enclosing the whole viewport.
+     * @param rect Rectangle to check against all members.
+     * @param contained Receives 1 for each member completely containing the rectangle, 0 otherwise.
+     */
+    void
+    contains(
+            Rectangle<T> const &rect,
+            Span<std::uint8_t> const contained
+    ) const
+    {
+        assert(contained.size() == size());
+        auto const bl = rect.bottomLeft();
+        auto const br = rect.bottomRight();
+        auto const tl = rect.topLeft();
+        auto const tr = rect.topRight();
+        T const *const a = mA.data();
+        T const *const b = mB.data();
+        T const *const f = mFoci.data();
+        std::uint8_t *const out = contained.data();
+        for (std::size_t i = 0, n = size(); i < n; i++)
+        {
+            out[i] = containsPoint(a[i], b[i], f[i], bl) & containsPoint(a[i], b[i], f[i], br) &
+                    containsPoint(a[i], b[i], f[i], tl) & containsPoint(a[i], b[i], f[i], tr);
+        }
+    }
+
+    /**
+     * Batched `Ellipse::pointToT()`.
+     * @attention Only gives reasonable values for points lying on the respective member.
+     * @param vectors Point per member.
+     * @param t Receives the parameter of each point.
+     */
+    void
+    pointToT(
+            Span<tvec<T> const> const vectors,
+            Span<Radian<T>> const t
+    ) const
+    {
+        assert(vectors.size() == size() && t.size() == size());
+        T const *const a = mA.data();
+        for (std::size_t i = 0, n = size(); i < n; i++)
+        {
+            T const tx = std::acos(vectors[i].x / a[i]);
+            t[i] = Radian<T>{vectors[i].y >= 0 ? tx : (2_pi).getRaw() - tx};
+        }
+    }
+
+    /**
+     * Batched `Ellipse::intersectPoints()`, not clipped to the line's bounds, e.g. to intersect many orbits with a
+     * viewport edge.
+     * @param line Line to intersect with all members.
+     * @param first Receives the first or only intersection point per member.
+     * @param second Receives the second intersection point per member.
+     * @param counts Receives the count of intersection points per member, which masks the valid points.
+     */
+    void
+    intersectPoints(
+            Line<T> const &line,
+            Span<tvec<T>> const first,
+            Span<tvec<T>> const second,
+            Span<std::uint8_t> const counts
+    ) const
+    {
+        assert(first.size() == size() && second.size() == size() && counts.size() == size());
+        T const d0 = line.d().x;
+        T const d1 = line.d().y;
+        T const p0 = line.p().x;
+        T const p1 = line.p().y;
+        T const *const a = mA.data();
+        T const *const b = mB.data();
+        std::uint8_t *const out = counts.data();
+        for (std::size_t i = 0, n = size(); i < n; i++)
+        {
+            T const a2 = sq(a[i]);
+            T const b2 = sq(b[i]);
+            T lambda0;
+            T lambda1;
+            out[i] = quadraticRoots(b2 * sq(d0) + a2 * sq(d1), 2 * (b2 * p0 * d0 + a2 * p1 * d1),
+                    b2 * sq(p0) + a2 * sq(p1) - a2 * b2, lambda0, lambda1);
+            first[i] = {p0 + lambda0 * d0, p1 + lambda0 * d1};
+            second[i] = {p0 + lambda1 * d0, p1 + lambda1 * d1};
+        }
+    }
+
+    /**
+     * Batched `Ellipse::boundingRect()`.
+     * @param rects Vector to append the bounding rectangle of each member to.
+     */
+    void
+    boundingRects(
+            std::vector<Rectangle<T>> &rects
+    ) const
+    {
+        rects.reserve(rects.size() + size());
+        for (std::size_t i = 0; i < size(); i++)
+        {
+            rects.emplace_back(tvec<T>{-mA[i], -mB[i]}, tvec<T>{mA[i], mB[i]});
+        }
+    }
+
+private:
+
+    std::vector<T> mA;      ///< Major semi-axes
+    std::vector<T> mB;      ///< Minor semi-axes
+    std::vector<T> mE;      ///< Numeric eccentricities
+    std::vector<T> mFoci;   ///< Positive focus x-values
+
+    /**
+     * Same as `Ellipse::contains()`, but evaluating all conditions without short circuiting, so it does not branch.
+     * @param a Major semi-axis.
+     * @param b Minor semi-axis.
+     * @param f Positive focus x-value.
+     * @param v Point to check.
+     * @return True if inside.
+     */
+    static bool
+    containsPoint(
+            T const a,
+            T const b,
+            T const f,
+            tvec<T> const v
+    )
+    {
+        T const d0 = std::sqrt(sq(v.x + f) + sq(v.y));
+        T const d1 = std::sqrt(sq(v.x - f) + sq(v.y));
+        return ((v.x == 0) & (v.y == 0)) | ((v.y == 0) & (v.x <= a) & (v.x >= -a)) |
+                ((v.x == 0) & (v.y <= b) & (v.y >= -b)) | (2 * a >= d0 + d1);
+    }
+
+};
@@ -7,6 +7,9 @@
 #include "Rectangle.h"
 #include <orbital/common/common.h>
 
+/**
+ * Immutable line between two points, as value type: Assignable, trivially copyable and standard layout.
+ */
 template<class T>
 class Line
 {
@@ -72,7 +75,7 @@ public:
 
 private:
 
-    tvec<T> const mP;
-    tvec<T> const mD;
+    tvec<T> mP;
+    tvec<T> mD;
 
 };
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <orbital/common/common.h>
+#include "trig.h"
 
 template<class T>
 class Radian
@@ -127,6 +128,18 @@ public:
         return std::cos(mRadians);
     }
 
+    /**
+     * Compute sine and cosine together, cheaper than calling `sin()` and `cos()` separately.
+     * @tparam TTrig Trigonometry policy, `PreciseTrig` or `FastTrig`.
+     * @return Sine and cosine.
+     */
+    template<class TTrig = PreciseTrig>
+    SinCos<T>
+    sincos() const
+    {
+        return TTrig::sincos(mRadians);
+    }
+
     T
     tan() const
     {
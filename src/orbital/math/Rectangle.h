@@ -7,6 +7,9 @@
 #include "Transform.h"
 #include "orbital/common/common.h"
 
+/**
+ * Immutable axis aligned rectangle, as value type: Assignable, trivially copyable and standard layout.
+ */
 template<class T>
 class Rectangle
 {
@@ -95,7 +98,7 @@ public:
      */
     bool
     containsTransformed(
-            Transform<T> const transform,
+            Transform<T> const &transform,
             vec const p
     ) const
     {
@@ -215,9 +218,9 @@ public:
 
 private:
 
-    tvec<T> const mBottomLeft;
-    T const mW;
-    T const mH;
+    tvec<T> mBottomLeft;
+    T mW;
+    T mH;
 
 };
 
@@ -4,12 +4,20 @@
 
 #pragma once
 
+#include <cassert>
 #include "Radian.h"
 #include <orbital/common/common.h>
-
-#include <glm/gtx/matrix_transform_2d.hpp>
-#include <glm/gtx/transform.hpp>
-
+#include <orbital/common/Span.h>
+
+/**
+ * 2D affine transformation.
+ *
+ * Stored as 2x3 matrix, i.e. the images of both axes and the translation, since the last row of the equivalent 3x3
+ * matrix is always \f$ (0, 0, 1) \f$. Applying it takes 4 multiplications, and inversion and composition have closed
+ * forms.
+ *
+ * Operations are appended on the right, like with glm: `translate(a).scale(s)` scales first, then translates.
+ */
 template<class T>
 class Transform
 {
@@ -17,14 +25,16 @@ class Transform
 public:
 
     Transform()
-        : mTransform{identityMatrix()}
+        : mX{1, 0}
+        , mY{0, 1}
+        , mT{0, 0}
     {
     }
 
     Transform &
     reset()
     {
-        mTransform = identityMatrix();
+        *this = Transform{};
         return *this;
     }
 
@@ -33,7 +43,7 @@ public:
             tvec<T> const &v
     )
     {
-        mTransform = glm::translate(mTransform, v);
+        mT = applied(v);
         return *this;
     }
 
@@ -42,7 +52,22 @@ public:
             T const s
     )
     {
-        mTransform = glm::scale(mTransform, tvec<T>{s, s});
+        mX *= s;
+        mY *= s;
+        return *this;
+    }
+
+    /**
+     * Scale both axes separately.
+     * @param s Scale per axis.
+     */
+    Transform &
+    scale(
+            tvec<T> const &s
+    )
+    {
+        mX *= s.x;
+        mY *= s.y;
         return *this;
     }
 
@@ -51,36 +76,134 @@ public:
             Radian<T> const radians
     )
     {
-        mTransform = glm::rotate(mTransform, radians.getRaw());
+        auto const [sin, cos] = radians.sincos();
+        tvec<T> const x = mX * cos + mY * sin;
+        mY = mY * cos - mX * sin;
+        mX = x;
         return *this;
     }
 
-    const mat &
+    /**
+     * @return Equivalent 3x3 matrix.
+     */
+    mat
     transformation() const
     {
-        return mTransform;
+        return {vec3{mX, 0}, vec3{mY, 0}, vec3{mT, 1}};
+    }
+
+    /**
+     * @return Image of the x-axis unit vector, i.e. the first matrix column.
+     */
+    tvec<T> const &
+    xAxis() const
+    {
+        return mX;
+    }
+
+    /**
+     * @return Image of the y-axis unit vector, i.e. the second matrix column.
+     */
+    tvec<T> const &
+    yAxis() const
+    {
+        return mY;
+    }
+
+    /**
+     * @return Translation, i.e. the image of the origin.
+     */
+    tvec<T> const &
+    translation() const
+    {
+        return mT;
     }
 
+    /**
+     * Closed form inverse of the linear part, \f$ \frac{1}{ad - bc} \begin{pmatrix} d & -b \\ -c & a \end{pmatrix} \f$,
+     * and the inverse linear part applied to the negated translation.
+     * @attention The transform must not be degenerated, i.e. not be scaled by 0.
+     * @return Inverse transform.
+     */
     Transform<T>
     inverse() const
     {
+        T const det = mX.x * mY.y - mY.x * mX.y;
+        assert(0 != det);
+
         Transform<T> result;
-        result.mTransform = glm::inverse(mTransform);
+        result.mX = tvec<T>{mY.y, -mX.y} / det;
+        result.mY = tvec<T>{-mY.x, mX.x} / det;
+        result.mT = -(result.mX * mT.x + result.mY * mT.y);
         return result;
     }
 
+    /**
+     * Compose with another transform.
+     * @param rhs Transform to apply first.
+     * @return Transform applying rhs, then this.
+     */
+    Transform<T>
+    operator*(
+            Transform<T> const &rhs
+    ) const
+    {
+        Transform<T> result;
+        result.mX = mX * rhs.mX.x + mY * rhs.mX.y;
+        result.mY = mX * rhs.mY.x + mY * rhs.mY.y;
+        result.mT = applied(rhs.mT);
+        return result;
+    }
+
+    Transform<T> &
+    operator*=(
+            Transform<T> const &rhs
+    )
+    {
+        return *this = *this * rhs;
+    }
+
     tvec<T>
     applied(
             tvec<T> const vec
     ) const
     {
-        return mTransform * glm::tvec3<T>{vec, 1.0};
+        return mX * vec.x + mY * vec.y + mT;
+    }
+
+    /**
+     * Apply the transform to many vectors, in a single loop the compiler can vectorize.
+     * @param vectors Vectors to transform.
+     * @param transformed Receives the transformed vectors, may be the same memory as vectors.
+     */
+    void
+    applyBatch(
+            Span<tvec<T> const> const vectors,
+            Span<tvec<T>> const transformed
+    ) const
+    {
+        assert(vectors.size() == transformed.size());
+        T const m00 = mX.x;
+        T const m01 = mX.y;
+        T const m10 = mY.x;
+        T const m11 = mY.y;
+        T const tx = mT.x;
+        T const ty = mT.y;
+        tvec<T> const *const in = vectors.data();
+        tvec<T> *const out = transformed.data();
+        for (std::size_t i = 0, n = vectors.size(); i < n; i++)
+        {
+            T const x = in[i].x;
+            T const y = in[i].y;
+            out[i].x = m00 * x + m10 * y + tx;
+            out[i].y = m01 * x + m11 * y + ty;
+        }
     }
 
 private:
 
-    mat mTransform;
+    tvec<T> mX;     ///< First column
+    tvec<T> mY;     ///< Second column
+    tvec<T> mT;     ///< Translation column
 
 };
-
-
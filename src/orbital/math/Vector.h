@@ -4,103 +4,607 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstring>
+#include <type_traits>
 #include <orbital/common/common.h>
-#include <orbital/common/range.h>
+
+/**
+ * SIMD packet holding a complete vector of N elements of type T, if supported.
+ *
+ * Supported are `float` and `double` with N from 2 to 4, using the GCC/Clang vector extension, which is lowered to
+ * SSE/AVX or NEON registers as available. 3D vectors are padded to 4 lanes, the padding lane is loaded as 0, but
+ * neither stored nor summed.
+ * Packets must fit into a single register, see `vectorSimdBytes()`, so without AVX 3D and 4D vectors of `double` are
+ * evaluated element-wise.
+ */
+template<class T, std::size_t N, class = void>
+struct VectorSimd
+{
+    static constexpr bool enabled = false;
+};
+
+#if defined(__GNUC__)
+
+/**
+ * @return Size of the largest packet held by a single register. Larger packets would be split and passed in memory,
+ * whose ABI differs between compilers.
+ */
+constexpr std::size_t
+vectorSimdBytes()
+{
+#if defined(__AVX__)
+    return 32;
+#else
+    return 16;
+#endif
+}
+
+template<class T, std::size_t N>
+struct VectorSimd<T, N, std::enable_if_t<(std::is_same_v<T, float> || std::is_same_v<T, double>) && 2 <= N && N <= 4
+                                         && sizeof(T) * (2 == N ? 2 : 4) <= vectorSimdBytes()>>
+{
+    static constexpr bool enabled = true;
+    static constexpr std::size_t lanes = 2 == N ? 2 : 4;
+
+    typedef T Packet __attribute__((vector_size(sizeof(T) * lanes)));
+
+    static Packet
+    load(
+            T const *const values
+    )
+    {
+        Packet packet{};
+        std::memcpy(&packet, values, N * sizeof(T));
+        return packet;
+    }
+
+    static void
+    store(
+            Packet const &packet,
+            T *const values
+    )
+    {
+        std::memcpy(values, &packet, N * sizeof(T));
+    }
+
+    /**
+     * Sum of the vector's elements. The padding lane is left out, since it does not stay 0 through all arithmetic, e.g.
+     * scaling by infinity makes it NaN.
+     */
+    static T
+    sum(
+            Packet const &packet
+    )
+    {
+        T result = packet[0];
+        for (std::size_t i = 1; i < N; i++)
+        {
+            result += packet[i];
+        }
+        return result;
+    }
+};
+
+#endif
+
+/**
+ * Base of all vector expressions: Vectors themselves and lazily evaluated arithmetic on them.
+ *
+ * Arithmetic on vectors does not compute anything, but builds an expression tree, which is evaluated at once when
+ * assigned to a `Vector`, or reduced by `dot()`. So `a + b * s - c` runs a single loop without temporaries, or a few
+ * SIMD instructions if `VectorSimd` supports the vector type.
+ *
+ * Each expression provides `operator[]` giving a single element, and `packet()` giving the whole expression as SIMD
+ * packet, only instantiated if supported.
+ *
+ * @attention Expressions refer to the vectors they were built from, so do not store them with `auto` beyond the
+ * lifetime of their operands.
+ */
+template<class E>
+struct VectorExpression
+{
+
+    constexpr E const &
+    self() const
+    {
+        return static_cast<E const &>(*this);
+    }
+
+};
 
+template<class T, std::size_t N>
+class Vector;
+
+/**
+ * Operands of expression nodes: Vectors are kept by reference, nested expressions by value, since they are
+ * temporaries.
+ */
+template<class E>
+using VectorOperand = std::conditional_t<std::is_base_of_v<Vector<typename E::ValueType, E::dimension>, E>,
+        E const &, E>;
+
+template<class L, class R>
+struct VectorSum
+        : VectorExpression<VectorSum<L, R>>
+{
+
+    using ValueType = typename L::ValueType;
+    static constexpr std::size_t dimension = L::dimension;
+
+    constexpr VectorSum(
+            L const &l,
+            R const &r
+    )
+            : l{l}
+            , r{r}
+    {
+    }
+
+    constexpr ValueType
+    operator[](
+            std::size_t const i
+    ) const
+    {
+        return l[i] + r[i];
+    }
+
+    auto
+    packet() const
+    {
+        return l.packet() + r.packet();
+    }
+
+    VectorOperand<L> l;
+    VectorOperand<R> r;
+
+};
+
+template<class L, class R>
+struct VectorDifference
+        : VectorExpression<VectorDifference<L, R>>
+{
+
+    using ValueType = typename L::ValueType;
+    static constexpr std::size_t dimension = L::dimension;
+
+    constexpr VectorDifference(
+            L const &l,
+            R const &r
+    )
+            : l{l}
+            , r{r}
+    {
+    }
+
+    constexpr ValueType
+    operator[](
+            std::size_t const i
+    ) const
+    {
+        return l[i] - r[i];
+    }
+
+    auto
+    packet() const
+    {
+        return l.packet() - r.packet();
+    }
+
+    VectorOperand<L> l;
+    VectorOperand<R> r;
+
+};
+
+template<class E>
+struct VectorScaled
+        : VectorExpression<VectorScaled<E>>
+{
+
+    using ValueType = typename E::ValueType;
+    static constexpr std::size_t dimension = E::dimension;
+
+    constexpr VectorScaled(
+            E const &e,
+            ValueType const s
+    )
+            : e{e}
+            , s{s}
+    {
+    }
+
+    constexpr ValueType
+    operator[](
+            std::size_t const i
+    ) const
+    {
+        return e[i] * s;
+    }
+
+    auto
+    packet() const
+    {
+        return e.packet() * s;
+    }
+
+    VectorOperand<E> e;
+    ValueType s;
+
+};
+
+template<class E>
+struct VectorQuotient
+        : VectorExpression<VectorQuotient<E>>
+{
+
+    using ValueType = typename E::ValueType;
+    static constexpr std::size_t dimension = E::dimension;
+
+    constexpr VectorQuotient(
+            E const &e,
+            ValueType const s
+    )
+            : e{e}
+            , s{s}
+    {
+    }
+
+    constexpr ValueType
+    operator[](
+            std::size_t const i
+    ) const
+    {
+        return e[i] / s;
+    }
+
+    auto
+    packet() const
+    {
+        return e.packet() / s;
+    }
+
+    VectorOperand<E> e;
+    ValueType s;
+
+};
+
+template<class E>
+struct VectorNegated
+        : VectorExpression<VectorNegated<E>>
+{
+
+    using ValueType = typename E::ValueType;
+    static constexpr std::size_t dimension = E::dimension;
+
+    constexpr explicit VectorNegated(
+            E const &e
+    )
+            : e{e}
+    {
+    }
+
+    constexpr ValueType
+    operator[](
+            std::size_t const i
+    ) const
+    {
+        return -e[i];
+    }
+
+    auto
+    packet() const
+    {
+        return -e.packet();
+    }
+
+    VectorOperand<E> e;
+
+};
+
+template<class L, class R>
+constexpr VectorSum<L, R>
+operator+(
+        VectorExpression<L> const &l,
+        VectorExpression<R> const &r
+)
+{
+    static_assert(L::dimension == R::dimension, "Vector sizes differ");
+    return {l.self(), r.self()};
+}
+
+template<class L, class R>
+constexpr VectorDifference<L, R>
+operator-(
+        VectorExpression<L> const &l,
+        VectorExpression<R> const &r
+)
+{
+    static_assert(L::dimension == R::dimension, "Vector sizes differ");
+    return {l.self(), r.self()};
+}
+
+template<class E>
+constexpr VectorScaled<E>
+operator*(
+        VectorExpression<E> const &e,
+        typename E::ValueType const s
+)
+{
+    return {e.self(), s};
+}
+
+template<class E>
+constexpr VectorScaled<E>
+operator*(
+        typename E::ValueType const s,
+        VectorExpression<E> const &e
+)
+{
+    return {e.self(), s};
+}
+
+/**
+ * Divide by a scalar, element-wise. Not multiplied with the reciprocal, which would round twice.
+ */
+template<class E>
+constexpr VectorQuotient<E>
+operator/(
+        VectorExpression<E> const &e,
+        typename E::ValueType const s
+)
+{
+    return {e.self(), s};
+}
+
+template<class E>
+constexpr VectorNegated<E>
+operator-(
+        VectorExpression<E> const &e
+)
+{
+    return VectorNegated<E>{e.self()};
+}
+
+/**
+ * Scalar product, evaluated in a single pass without intermediate vectors.
+ * @param l Left expression.
+ * @param r Right expression.
+ * @return \f$ \vec{l} \cdot \vec{r} \f$
+ */
+template<class L, class R>
+typename L::ValueType
+dot(
+        VectorExpression<L> const &l,
+        VectorExpression<R> const &r
+)
+{
+    static_assert(L::dimension == R::dimension, "Vector sizes differ");
+    using Simd = VectorSimd<typename L::ValueType, L::dimension>;
+    if constexpr (Simd::enabled)
+    {
+        return Simd::sum(l.self().packet() * r.self().packet());
+    }
+    else
+    {
+        typename L::ValueType result{};
+        for (std::size_t i = 0; i < L::dimension; i++)
+        {
+            result += l.self()[i] * r.self()[i];
+        }
+        return result;
+    }
+}
+
+/**
+ * @param e Expression.
+ * @return Euclidean length.
+ */
+template<class E>
+typename E::ValueType
+norm(
+        VectorExpression<E> const &e
+)
+{
+    return std::sqrt(dot(e, e));
+}
+
+/**
+ * Element-wise comparison of evaluated expressions.
+ */
+template<class L, class R>
+constexpr bool
+operator==(
+        VectorExpression<L> const &l,
+        VectorExpression<R> const &r
+)
+{
+    static_assert(L::dimension == R::dimension, "Vector sizes differ");
+    bool equal = true;
+    for (std::size_t i = 0; i < L::dimension; i++)
+    {
+        equal = equal && l.self()[i] == r.self()[i];
+    }
+    return equal;
+}
+
+template<class L, class R>
+constexpr bool
+operator!=(
+        VectorExpression<L> const &l,
+        VectorExpression<R> const &r
+)
+{
+    return !(l == r);
+}
+
+template<class E>
+std::ostream &
+operator<<(
+        std::ostream &os,
+        VectorExpression<E> const &e
+)
+{
+    os << '(';
+    for (std::size_t i = 0; i < E::dimension; i++)
+    {
+        os << e.self()[i];
+        if (i < E::dimension - 1)
+        {
+            os << ", ";
+        }
+    }
+    os << ')';
+    return os;
+}
+
+/**
+ * Exact overloads for vectors, so comparing them does not resolve ambiguously to `std::array`'s comparison.
+ */
+template<class T, std::size_t N>
+constexpr bool
+operator==(
+        Vector<T, N> const &l,
+        Vector<T, N> const &r
+)
+{
+    using Expression = VectorExpression<Vector<T, N>>;
+    return static_cast<Expression const &>(l) == static_cast<Expression const &>(r);
+}
+
+template<class T, std::size_t N>
+constexpr bool
+operator!=(
+        Vector<T, N> const &l,
+        Vector<T, N> const &r
+)
+{
+    return !(l == r);
+}
+
+/**
+ * Fixed size vector, evaluating arithmetic through expression templates, see `VectorExpression`.
+ */
 template<class T, std::size_t N>
 class Vector
         : public std::array<T, N>
+        , public VectorExpression<Vector<T, N>>
 {
 
     using ArrayType = std::array<T, N>;
     using SizeType = decltype(N);
     using VectorType = Vector<T, N>;
+    using Simd = VectorSimd<T, N>;
 
 public:
 
+    using ValueType = T;
+    static constexpr std::size_t dimension = N;
+
     constexpr Vector()
+            : ArrayType{}
     {
-        ArrayType::fill(T{});
     }
 
     constexpr Vector(
             std::initializer_list<T> const &il
     )
+            : ArrayType{}
     {
-        std::copy(il.begin(), il.begin() + N, ArrayType::begin());
-        if (il.size() < N)
+        for (SizeType i{}; i < std::min(N, il.size()); i++)
         {
-            std::fill(ArrayType::begin() + il.size(), ArrayType::end(), T{});
+            (*this)[i] = il.begin()[i];
         }
     }
 
     constexpr explicit Vector(
             ArrayType const &array
     )
+            : ArrayType{array}
     {
-        std::copy(array.begin(), array.begin() + N, ArrayType::begin());
-        if (array.size() < N)
-        {
-            std::fill(ArrayType::begin() + array.size(), ArrayType::end(), T{});
-        }
     }
 
-    constexpr VectorType
-    operator+(
-            VectorType const &rhs
-    ) const
+    /**
+     * Evaluate an expression.
+     * @param e Expression to evaluate.
+     */
+    template<class E>
+    Vector(
+            VectorExpression<E> const &e
+    )
     {
-        VectorType result{};
-        for(SizeType i{}; i < N; i++)
-        {
-            result[i] = (*this)[i] + rhs[i];
-        }
-        return result;
+        assign(e.self());
     }
 
-    constexpr VectorType
-    operator-(
-            VectorType const &rhs
-    ) const
+    template<class E>
+    VectorType &
+    operator=(
+            VectorExpression<E> const &e
+    )
     {
-        VectorType result{};
-        for(SizeType i{}; i < N; i++)
-        {
-            result[i] = (*this)[i] - rhs[i];
-        }
-        return result;
+        assign(e.self());
+        return *this;
     }
 
-    constexpr bool
-    operator==(
-            VectorType const &rhs
-    ) const
+    template<class E>
+    VectorType &
+    operator+=(
+            VectorExpression<E> const &e
+    )
+    {
+        return *this = *this + e;
+    }
+
+    template<class E>
+    VectorType &
+    operator-=(
+            VectorExpression<E> const &e
+    )
+    {
+        return *this = *this - e;
+    }
+
+    VectorType &
+    operator*=(
+            T const s
+    )
+    {
+        return *this = *this * s;
+    }
+
+    /**
+     * @return Whole vector as SIMD packet.
+     */
+    auto
+    packet() const
     {
-        return reduce_range(SizeType{}, N, true, [&](
-                bool const &b,
-                SizeType const &index
-        ) {
-            return ((*this)[index] == rhs[index]) && b;
-        });
+        return Simd::load(ArrayType::data());
     }
 
-    friend std::ostream &
-    operator<<(
-            std::ostream &os,
-            Vector<T, N> const &vector
+private:
+
+    /**
+     * Evaluate an expression into this vector. The expression is evaluated completely before storing, or element-wise
+     * by index, so it may refer to this vector.
+     * @param e Expression to evaluate.
+     */
+    template<class E>
+    void
+    assign(
+            E const &e
     )
     {
-        os << '(';
-        for(SizeType i{}; i < N; i++)
+        static_assert(E::dimension == N, "Vector sizes differ");
+        if constexpr (Simd::enabled)
         {
-            os << vector[i];
-            if(i < N - SizeType{1})
+            Simd::store(e.packet(), ArrayType::data());
+        }
+        else
+        {
+            for (SizeType i{}; i < N; i++)
             {
-                os << ", ";
+                (*this)[i] = e[i];
             }
         }
-        os << ')';
-        return os;
     }
 
 };
@@ -113,6 +617,25 @@ class Vector2d
 public:
 
     using Vector<T, 2>::Vector;
+    using Vector<T, 2>::operator=;
+
+    /**
+     * Convert from glm.
+     */
+    constexpr explicit Vector2d(
+            tvec<T> const &v
+    )
+            : Vector<T, 2>{v.x, v.y}
+    {
+    }
+
+    /**
+     * Convert to glm.
+     */
+    constexpr explicit operator tvec<T>() const
+    {
+        return {x(), y()};
+    }
 
     constexpr T &
     x()
@@ -148,6 +671,7 @@ class Vector3d
 public:
 
     using Vector<T, 3>::Vector;
+    using Vector<T, 3>::operator=;
 
     constexpr T &
     x()
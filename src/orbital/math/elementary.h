@@ -7,6 +7,14 @@
 #include "Radian.h"
 #include <orbital/common/common.h>
 #include <orbital/common/range.h>
+#include <orbital/common/Span.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 /**
  * Compute the average over a given set of values.
@@ -90,44 +98,223 @@ angle(
     return Radian<T>::arctan2(v.y, v.x);
 }
 
+/**
+ * Give the underlying number of a scalar, e.g. the raw value of a Radian.
+ * @param x Scalar.
+ * @return Plain number.
+ */
+template<class T>
+constexpr T
+raw(
+        T const x
+)
+{
+    return x;
+}
+
+template<class T>
+constexpr T
+raw(
+        Radian<T> const x
+)
+{
+    return x.getRaw();
+}
+
+/**
+ * @return Maximum count of sub-intervals `integral()` splits the integration range into.
+ */
+constexpr std::size_t
+integralMaxSegments()
+{
+    return 1000;
+}
+
 /**
  * Integrate a function over a given range: \f$ \int_{low}^{high} f(x) dx \f$
- * @attention If the resolution is greater than 1, it is required to be able to hold fractional values. As integer
- * types would truncate to 0, giving integer types in such a case will lead to 0 division.
+ *
+ * Uses adaptive 7-point Gauss, 15-point Kronrod quadrature: The range is evaluated by both rules at once, and the
+ * difference of both results serves as error estimate. The sub-interval with the largest error is bisected until the
+ * summed error estimate falls below the tolerance. Smooth functions are integrated to machine precision with very
+ * few evaluations, e.g. 15 for any polynomial up to degree 22.
+ *
+ * If the tolerance cannot be reached within `integralMaxSegments()` sub-intervals, e.g. due to a singularity, the best
+ * result found is returned.
+ *
  * @param f Function to integrate on.
- * @param args Arguments to pass to f, see std::apply().
+ * @param args Arguments to pass to f before x, see std::invoke().
  * @param low Lower integration bound.
  * @param high Upper integration bound.
- * @param resolution Resolution per x stepping, i.e. number of function invocations per x.
+ * @param tolerance Absolute error tolerated, must be positive.
  * @return Area enclosed by graph and x-axis.
  */
 template<class TFun, class... TArgs, class T, class Tx>
-constexpr Tx
+Tx
 integral(
         Tx const low,
         Tx const high,
-        T const resolution,
+        T const tolerance,
         TFun &&f,
         TArgs &&...args
 )
 {
-    // Step points to negative x if high is smaller than low
-    T const step = (low < high ? T{1} : T{-1}) / resolution;
-    auto const steps = (high - low) / step;
+    using R = decltype(raw(low));
+
+    // Kronrod nodes and weights, nodes at odd indices are shared with the Gauss rule:
+    static constexpr R nodes[8]{
+            0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+            0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+            0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+            0.207784955007898467600689403773245, 0};
+    static constexpr R kronrod[8]{
+            0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+            0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+            0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+            0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+    static constexpr R gauss[4]{
+            0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+            0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+
+    struct Segment
+    {
+        R a;
+        R b;
+        R value;
+        R error;
+
+        bool
+        operator<(
+                Segment const &rhs
+        ) const
+        {
+            return error < rhs.error;
+        }
+    };
+
+    auto evaluate = [&](R const x) -> R {
+        Tx const value{x};
+        if constexpr (0 == sizeof...(TArgs) && std::is_member_function_pointer_v<std::decay_t<TFun>>)
+        {
+            // Members of x, e.g. `&Radian<T>::sin`, are called directly. GCC mistakes calling them by std::invoke()
+            // for reading an uninitialized object:
+            return raw(Tx{(value.*f)()});
+        }
+        else
+        {
+            return raw(Tx{std::invoke(f, args..., value)});
+        }
+    };
 
-    return reduce_range(Tx{}, steps, Tx{}, [&](
-            Tx const sum,
-            auto const i
+    auto quadrature = [&](
+            R const a,
+            R const b
     ) {
-        return sum + Tx{std::apply(std::forward<TFun>(f),
-                std::tuple{std::forward<TFun>(args)..., low + (i + Tx(0.5)) * step})} * step;
-    });
+        R const center = (a + b) / 2;
+        R const half = (b - a) / 2;
+
+        R const fc = evaluate(center);
+        R k = kronrod[7] * fc;
+        R g = gauss[3] * fc;
+        for (std::size_t i = 0; i < 7; i++)
+        {
+            R const pair = evaluate(center - half * nodes[i]) + evaluate(center + half * nodes[i]);
+            k += kronrod[i] * pair;
+            if (1 == i % 2)
+            {
+                g += gauss[i / 2] * pair;
+            }
+        }
+        return Segment{a, b, k * half, std::abs((k - g) * half)};
+    };
+
+    // Max-heap of sub-intervals ordered by error estimate:
+    std::vector<Segment> segments{quadrature(raw(low), raw(high))};
+    R error = segments.front().error;
+    while (error > tolerance && segments.size() < integralMaxSegments())
+    {
+        std::pop_heap(segments.begin(), segments.end());
+        Segment const worst = segments.back();
+        segments.pop_back();
+
+        R const center = (worst.a + worst.b) / 2;
+        for (auto const &half : {quadrature(worst.a, center), quadrature(center, worst.b)})
+        {
+            segments.push_back(half);
+            std::push_heap(segments.begin(), segments.end());
+        }
+
+        // Recompute instead of updating incrementally, to not accumulate cancellation errors:
+        error = 0;
+        for (auto const &segment : segments)
+        {
+            error += segment.error;
+        }
+    }
+
+    R value = 0;
+    for (auto const &segment : segments)
+    {
+        value += segment.value;
+    }
+    return Tx{value};
+}
+
+/**
+ * Relative tolerance of the quadratic discriminant, below which both roots are considered to coincide.
+ * Computing \f$ b^2 - 4ac \f$ rounds by about \f$ \epsilon b^2 \f$ per term when the roots are close, so smaller
+ * discriminants carry no information about the distance of the roots, not even their sign.
+ * @return Factor of \f$ b^2 \f$.
+ */
+template<class T>
+constexpr T
+quadraticTolerance()
+{
+    return 4 * std::numeric_limits<T>::epsilon();
+}
+
+/**
+ * Solve \f$ 0 = ax^2 + bx + c \f$ without branching, for use in loops over many quadratics.
+ *
+ * Uses the numerically stable form \f$ q = -\frac{1}{2} (b + sgn(b) \sqrt{b^2 - 4ac}) \f$,
+ * \f$ x_1 = \frac{q}{a} \f$, \f$ x_2 = \frac{c}{q} \f$, which never subtracts nearly equal values, unlike the textbook
+ * formula \f$ \frac{-b \pm \sqrt{b^2 - 4ac}}{2a} \f$ does for one of its roots if \f$ 4ac \ll b^2 \f$.
+ *
+ * @attention a must not be 0. Roots not counted hold unspecified values.
+ * @tparam TCount Integer type of the count.
+ * @param a A
+ * @param b B
+ * @param c C
+ * @param x0 Receives the smaller root, or the only root.
+ * @param x1 Receives the greater root.
+ * @return Count of roots: 0, 1 or 2. Roots closer than the discriminant's rounding error count as one.
+ */
+template<class TCount = std::uint8_t, class T>
+TCount
+quadraticRoots(
+        T const a,
+        T const b,
+        T const c,
+        T &x0,
+        T &x1
+)
+{
+    T const d = b * b - 4 * a * c;
+    T const tolerance = quadraticTolerance<T>() * b * b;
+    bool const single = d <= tolerance;
+
+    // With the discriminant taken as 0 for a single root, q / a gives it as -b / 2a:
+    T const q = T(-0.5) * (b + std::copysign(single ? T(0) : std::sqrt(d), b));
+    T const r0 = q / a;
+    T const r1 = c / q;
+    x0 = single ? r0 : std::min(r0, r1);
+    x1 = std::max(r0, r1);
+    return static_cast<TCount>((d >= -tolerance) + (d > tolerance));
 }
 
 /**
  * Computes the quadratic formula: \f$ 0 = ax^2 + bx + c \f$
  *
- * Midnight formula: \f$ x_{1,2} = \frac{ -b \pm \sqrt{b^2 - 4ac} }{2a} \f$
+ * See `quadraticRoots()` for the numerically stable formula used. If a is 0, the linear equation is solved.
  *
  * @param a A
  * @param b B
@@ -142,21 +329,79 @@ quadratic(
         T const c
 )
 {
-    T const d = sq(b) - 4 * a * c;
+    DynamicArray<T, 2> solutions;
+    if (0 == a)
+    {
+        if (0 != b)
+        {
+            solutions.emplace_back(-c / b);
+        }
+        return solutions;
+    }
 
-    if (0 > d)
+    T x0;
+    T x1;
+    auto const count = quadraticRoots(a, b, c, x0, x1);
+    if (count > 0)
     {
-        // No solutions:
-        return {};
+        solutions.emplace_back(x0);
     }
-    if (0 == d)
+    if (count > 1)
     {
-        // One solution, discriminant does not play any role as it's 0 anyway:
-        return {-b / (2 * a)};
+        solutions.emplace_back(x1);
     }
+    return solutions;
+}
 
-    // Two solutions:
-    T const x1 = (-b + std::sqrt(d)) / (2 * a);
-    T const x2 = (-b - std::sqrt(d)) / (2 * a);
-    return {std::min(x1, x2), std::max(x1, x2)};
-};
+/**
+ * Solve many quadratics \f$ 0 = a_i x^2 + b_i x + c_i \f$ at once, see `quadraticRoots()`.
+ * Coefficients and results are passed as structure of arrays, so the loop vectorizes, given `-fno-math-errno` for
+ * the square root, i.e. when built with the `ORBITAL_NATIVE` CMake option.
+ *
+ * @attention No a may be 0.
+ * @param a A per quadratic.
+ * @param b B per quadratic.
+ * @param c C per quadratic.
+ * @param x0 Receives the smaller or only root per quadratic.
+ * @param x1 Receives the greater root per quadratic.
+ * @param counts Receives the count of roots per quadratic, which masks the valid entries of x0 and x1.
+ */
+template<class T>
+void
+quadraticBatch(
+        Span<T const> const a,
+        Span<T const> const b,
+        Span<T const> const c,
+        Span<T> const x0,
+        Span<T> const x1,
+        Span<std::uint8_t> const counts
+)
+{
+    std::size_t const n = a.size();
+    assert(b.size() == n && c.size() == n && x0.size() == n && x1.size() == n && counts.size() == n);
+    T const *const pa = a.data();
+    T const *const pb = b.data();
+    T const *const pc = c.data();
+    T *const px0 = x0.data();
+    T *const px1 = x1.data();
+    std::uint8_t *const pcounts = counts.data();
+
+    // Counts are first stored as integers as wide as T, since compilers do not vectorize narrowing the comparison
+    // masks within the same loop:
+    using Wide = std::conditional_t<sizeof(T) == sizeof(std::int64_t), std::int64_t, std::int32_t>;
+    constexpr std::size_t chunkSize = 256;
+    Wide wide[chunkSize];
+    for (std::size_t offset = 0; offset < n; offset += chunkSize)
+    {
+        std::size_t const m = std::min(chunkSize, n - offset);
+        for (std::size_t j = 0; j < m; j++)
+        {
+            std::size_t const i = offset + j;
+            wide[j] = quadraticRoots<Wide>(pa[i], pb[i], pc[i], px0[i], px1[i]);
+        }
+        for (std::size_t j = 0; j < m; j++)
+        {
+            pcounts[offset + j] = static_cast<std::uint8_t>(wide[j]);
+        }
+    }
+}
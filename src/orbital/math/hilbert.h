@@ -0,0 +1,49 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+/**
+ * Position of a grid cell along the Hilbert curve filling a grid of \f$ 2^{32} \times 2^{32} \f$ cells.
+ *
+ * Cells following each other on the curve are always adjacent, and cells close to each other mostly are close on the
+ * curve, more so than by the Morton order, which jumps between quadrants. So sorting points by their index stores
+ * points close in space close in memory.
+ *
+ * Evaluated from the most significant bit down, after Hilbert's recursive construction: Each level adds the index of
+ * the quadrant, and rotates or mirrors the remaining bits into the orientation of the sub-curve within it.
+ *
+ * @param x Cell column.
+ * @param y Cell row.
+ * @return Index along the curve.
+ */
+inline std::uint64_t
+hilbertIndex(
+        std::uint32_t x,
+        std::uint32_t y
+)
+{
+    std::uint64_t index = 0;
+    for (std::uint32_t s = 1u << 31u; s > 0; s >>= 1u)
+    {
+        std::uint32_t const rx = (x & s) ? 1 : 0;
+        std::uint32_t const ry = (y & s) ? 1 : 0;
+        index += std::uint64_t{s} * s * ((3 * rx) ^ ry);
+
+        // Lower quadrants hold the sub-curve transposed, and the lower right one also mirrored:
+        if (0 == ry)
+        {
+            if (1 == rx)
+            {
+                x = ~x;
+                y = ~y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
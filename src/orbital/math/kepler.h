@@ -0,0 +1,215 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <boost/math/constants/constants.hpp>
+#include <orbital/common/common.h>
+
+/**
+ * Stumpff function \f$ C(z) = \frac{1 - cos \sqrt{z}}{z} \f$, continued for \f$ z \le 0 \f$.
+ * Evaluated by its series near 0, where the closed form cancels.
+ * @param z Argument, \f$ \alpha \chi^2 \f$ in the universal variable formulation.
+ * @return C(z)
+ */
+template<class T>
+T
+stumpffC(
+        T const z
+)
+{
+    if (std::abs(z) < T(1e-3))
+    {
+        return T(1) / 2 - z * (T(1) / 24 - z * (T(1) / 720 - z / 40320));
+    }
+    if (z > 0)
+    {
+        return (1 - std::cos(std::sqrt(z))) / z;
+    }
+    return (std::cosh(std::sqrt(-z)) - 1) / -z;
+}
+
+/**
+ * Stumpff function \f$ S(z) = \frac{\sqrt{z} - sin \sqrt{z}}{\sqrt{z}^3} \f$, continued for \f$ z \le 0 \f$.
+ * Evaluated by its series near 0, where the closed form cancels.
+ * @param z Argument, \f$ \alpha \chi^2 \f$ in the universal variable formulation.
+ * @return S(z)
+ */
+template<class T>
+T
+stumpffS(
+        T const z
+)
+{
+    if (std::abs(z) < T(1e-3))
+    {
+        return T(1) / 6 - z * (T(1) / 120 - z * (T(1) / 5040 - z / 362880));
+    }
+    if (z > 0)
+    {
+        T const s = std::sqrt(z);
+        return (s - std::sin(s)) / (s * s * s);
+    }
+    T const s = std::sqrt(-z);
+    return (std::sinh(s) - s) / (s * s * s);
+}
+
+/**
+ * @return Maximum count of iterations `keplerDrift()` spends solving Kepler's equation.
+ */
+constexpr std::size_t
+keplerMaxIterations()
+{
+    return 50;
+}
+
+/**
+ * State of a body after `keplerDrift()`.
+ */
+template<class T>
+struct KeplerDrift
+{
+    tvec<T> position;       ///< [m]    Relative to the central body
+    tvec<T> velocity;       ///< [m/s]  Relative to the central body
+    std::size_t iterations; ///<        Iterations spent solving Kepler's equation
+};
+
+/**
+ * Propagate a body along its two-body orbit around a central mass by a time step.
+ *
+ * Uses the universal variable formulation of Kepler's equation, valid for elliptic, parabolic and hyperbolic orbits
+ * alike, which is solved for the universal anomaly \f$ \chi \f$ by the Laguerre-Conway method, converging for
+ * eccentricities close to 1 where Newton's method starts to oscillate:
+ *
+ * \f$
+ *    \sqrt{\mu} \Delta t = \frac{r_0 v_{r0}}{\sqrt{\mu}} \chi^2 C(z) + (1 - \alpha r_0) \chi^3 S(z) + r_0 \chi,
+ *    \quad z = \alpha \chi^2, \quad \alpha = \frac{2}{r_0} - \frac{v_0^2}{\mu}
+ * \f$
+ *
+ * The new state follows from the Lagrange coefficients f, g, \f$ \dot{f} \f$, \f$ \dot{g} \f$. For bound orbits, the
+ * time step is first reduced by whole periods, so the iteration always starts within one revolution.
+ *
+ * @param mu [m³/s²] Gravitational parameter of the central body, \f$ G M \f$.
+ * @param r [m] Position relative to the central body, must not be 0.
+ * @param v [m/s] Velocity relative to the central body.
+ * @param dt [s] Time step, may be negative.
+ * @return New state, and the count of iterations.
+ * @throw std::runtime_error If the iteration does not converge within `keplerMaxIterations()`.
+ */
+template<class T>
+KeplerDrift<T>
+keplerDrift(
+        T const mu,
+        tvec<T> const r,
+        tvec<T> const v,
+        T dt
+)
+{
+    T const sqrtMu = std::sqrt(mu);
+    T const r0 = std::sqrt(r.x * r.x + r.y * r.y);
+    T const rv = (r.x * v.x + r.y * v.y) / sqrtMu;
+    T const alpha = 2 / r0 - (v.x * v.x + v.y * v.y) / mu;
+
+    if (alpha > 0)
+    {
+        T const period = 2 * boost::math::constants::pi<T>() / (sqrtMu * alpha * std::sqrt(alpha));
+        dt = std::remainder(dt, period);
+    }
+
+    // Initial guesses: For short steps, the anomaly grows linearly, which is exact for circular orbits. Else after
+    // Vallado, "Fundamentals of Astrodynamics and Applications", algorithm 8, by the mean motion for bound orbits, and
+    // logarithmically for hyperbolic ones:
+    T chi = sqrtMu * dt / r0;
+    if (alpha > 0)
+    {
+        if (std::abs(chi) > std::abs(sqrtMu * alpha * dt) * 2)
+        {
+            chi = sqrtMu * alpha * dt;
+        }
+    }
+    else if (alpha < 0 && 0 != dt)
+    {
+        T const a = 1 / alpha;
+        T const sign = std::copysign(T(1), dt);
+        T const estimate = sign * std::sqrt(-a) * std::log(-2 * mu * alpha * dt /
+                (rv * sqrtMu + sign * std::sqrt(-mu * a) * (1 - r0 * alpha)));
+        if (estimate * dt > 0 && std::abs(estimate) < std::abs(chi))
+        {
+            chi = estimate;
+        }
+    }
+    // Convergence is of third order near the root, so once a step falls below the square root of the precision, the
+    // updated anomaly is exact to working precision. Tighter bounds may never be met, since Kepler's equation loses
+    // some digits to cancellation:
+    T const tolerance = std::sqrt(std::numeric_limits<T>::epsilon());
+    T c = 0;
+    T s = 0;
+    std::size_t iterations = 0;
+
+    // The time of flight grows monotonically with the anomaly, so the root stays bracketed by the anomalies evaluated
+    // so far. On nearly radial orbits, steps taken close to periapsis may overshoot by far, to where the time of flight
+    // grows exponentially and steps only walk back slowly. So whenever a step leaves the bracket, or is not at most half
+    // as long as the last one taken, the bracket is bisected instead:
+    T low = -std::numeric_limits<T>::infinity();
+    T high = std::numeric_limits<T>::infinity();
+    T previous = std::numeric_limits<T>::infinity();
+    for (;;)
+    {
+        if (iterations == keplerMaxIterations())
+        {
+            throw std::runtime_error{"Kepler's equation did not converge"};
+        }
+        iterations++;
+
+        T const chi2 = chi * chi;
+        T const z = alpha * chi2;
+        c = stumpffC(z);
+        s = stumpffS(z);
+        T const f = rv * chi2 * c + (1 - alpha * r0) * chi2 * chi * s + r0 * chi - sqrtMu * dt;
+        T const df = rv * chi * (1 - z * s) + (1 - alpha * r0) * chi2 * c + r0;
+        T const ddf = rv * (1 - z * c) + (1 - alpha * r0) * chi * (1 - z * s);
+
+        // Laguerre-Conway step of degree 5, damps the overshooting of Newton's steps on highly eccentric orbits:
+        T const n = 5;
+        T const root = std::sqrt(std::abs((n - 1) * (n - 1) * df * df - n * (n - 1) * f * ddf));
+        T delta = n * f / (df + std::copysign(root, df));
+
+        // Far beyond periapsis of hyperbolic orbits, the Stumpff functions overflow, where the time of flight has the
+        // sign of the anomaly:
+        (std::isnan(f) ? chi < 0 : f < 0) ? low = chi : high = chi;
+        bool const bracketed = std::isfinite(low) && std::isfinite(high);
+        if (bracketed && (!std::isfinite(delta) || chi - delta <= low || chi - delta >= high ||
+                std::abs(delta) > std::abs(previous) / 2))
+        {
+            delta = chi - (low + high) / 2;
+        }
+        else
+        {
+            previous = delta;
+        }
+        chi -= delta;
+        if (std::abs(delta) <= tolerance * std::max(std::abs(chi), std::sqrt(r0)))
+        {
+            break;
+        }
+    }
+
+    T const chi2 = chi * chi;
+    T const z = alpha * chi2;
+    c = stumpffC(z);
+    s = stumpffS(z);
+
+    T const f = 1 - chi2 / r0 * c;
+    T const g = dt - chi2 * chi / sqrtMu * s;
+    tvec<T> const position{f * r.x + g * v.x, f * r.y + g * v.y};
+    T const rn = std::sqrt(position.x * position.x + position.y * position.y);
+    T const df = sqrtMu / (rn * r0) * (z * chi * s - chi);
+    T const dg = 1 - chi2 / rn * c;
+    return {position, {df * r.x + dg * v.x, df * r.y + dg * v.y}, iterations};
+}
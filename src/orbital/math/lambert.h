@@ -0,0 +1,252 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <orbital/common/common.h>
+#include <orbital/common/Span.h>
+
+/**
+ * @return Maximum count of iterations `lambert()` takes. Most transfers converge within 3 iterations, transfers
+ * between nearly the same directions within about a dozen, and bisection alone would take about 40.
+ */
+constexpr std::size_t
+lambertIterations()
+{
+    return 64;
+}
+
+/**
+ * @return Step of Izzo's variable x, relative to 1 + |x|, below which `lambert()` considers it converged.
+ */
+constexpr double
+lambertTolerance()
+{
+    return 1e-12;
+}
+
+/**
+ * Non-dimensional time of flight of a transfer without complete revolutions, as function of Izzo's variable x.
+ *
+ * Lancaster's closed form cancels near parabolic transfers \f$ x = 1 \f$, where Battin's hypergeometric series is
+ * used instead. Only the selected form is evaluated.
+ *
+ * @param x Izzo's variable, \f$ x > -1 \f$: below 1 for elliptic, above 1 for hyperbolic transfers.
+ * @param lambda Geometry parameter \f$ \lambda = \pm \sqrt{1 - c / s} \f$, negative for transfer angles above π.
+ * @return Time of flight, \f$ T = \sqrt{2 \mu / s^3} \Delta t \f$.
+ */
+template<class T>
+T
+lambertTimeOfFlight(
+        T const x,
+        T const lambda
+)
+{
+    T const e = x * x - 1;
+    T const z = std::sqrt(1 + lambda * lambda * e);
+
+    if (std::abs(x - 1) < T(0.01))
+    {
+        // Battin: \f$ \frac{1}{2} (\frac{4}{3} \eta^3 F(3, 1; \frac{5}{2}; S_1) + 4 \lambda \eta) \f$, whose argument
+        // is within 0.01 of 0 here, so a dozen terms are exact to working precision:
+        T const eta = z - lambda * x;
+        T const s1 = (1 - lambda - x * eta) / 2;
+        T term = 1;
+        T hypergeometric = 1;
+        for (int j = 0; j < 12; j++)
+        {
+            term *= (3 + j) / (T(2.5) + j) * s1;
+            hypergeometric += term;
+        }
+        return (eta * eta * eta * hypergeometric * 4 / 3 + 4 * lambda * eta) / 2;
+    }
+
+    // Lancaster: \f$ \frac{x - \lambda z - d / y}{E} \f$, with d by the elliptic or hyperbolic anomaly:
+    T const y = std::sqrt(std::abs(e));
+    T const g = x * z - lambda * e;
+    T const d = e < 0 ? std::acos(std::clamp(g, T(-1), T(1))) : std::log(std::max(y * (z - lambda * x) + g, T(1)));
+    return (x - lambda * z - d / y) / e;
+}
+
+/**
+ * Solve Lambert's problem by Izzo's algorithm, see Izzo, "Revisiting Lambert's problem", 2015: Find the conic
+ * through two positions taking a given time of flight, counterclockwise, without complete revolutions.
+ *
+ * The time of flight is a function of a single variable x, which Householder's method of third order finds from an
+ * initial guess exact to a few percent, iterating until x changes by less than `lambertTolerance()`. Transfers
+ * between nearly the same or opposite directions, i.e. \f$ \lambda \to \pm 1 \f$, make the method overshoot, which
+ * is caught by keeping the root bracketed and bisecting instead. Transfers not converging within
+ * `lambertIterations()` give NaN velocities.
+ *
+ * @param mu [m³/s²] Gravitational parameter of the central body.
+ * @param r1x, r1y [m] Departure position, relative to the central body.
+ * @param r2x, r2y [m] Arrival position, relative to the central body.
+ * @param tof [s] Time of flight. Transfers not taking positive time give NaN velocities.
+ * @param v1x, v1y [m/s] Receives the departure velocity.
+ * @param v2x, v2y [m/s] Receives the arrival velocity.
+ */
+template<class T>
+void
+lambertSolve(
+        T const mu,
+        T const r1x,
+        T const r1y,
+        T const r2x,
+        T const r2y,
+        T const tof,
+        T &v1x,
+        T &v1y,
+        T &v2x,
+        T &v2y
+)
+{
+    T const dx = r2x - r1x;
+    T const dy = r2y - r1y;
+    T const c = std::sqrt(dx * dx + dy * dy);
+    T const R1 = std::sqrt(r1x * r1x + r1y * r1y);
+    T const R2 = std::sqrt(r2x * r2x + r2y * r2y);
+    T const s = (R1 + R2 + c) / 2;
+
+    // Counterclockwise transfers by more than half a turn have the positions in clockwise order:
+    T const cross = r1x * r2y - r1y * r2x;
+    T const lambda = std::copysign(std::sqrt(std::max(1 - c / s, T(0))), cross);
+    T const lambda2 = lambda * lambda;
+    T const lambda3 = lambda2 * lambda;
+
+    // Not positive times of flight give NaN throughout, rather than some transfer backwards:
+    T const time = tof > 0 ? std::sqrt(2 * mu / (s * s * s)) * tof : std::numeric_limits<T>::quiet_NaN();
+
+    // Initial guess, by the times of flight at x = 0 and of the parabola at x = 1:
+    T const t0 = std::acos(lambda) + lambda * std::sqrt(1 - lambda2);
+    T const t1 = 2 * (1 - lambda3) / 3;
+    T const long0 = std::pow(t0 / time, T(2) / 3) - 1;
+    T const short0 = T(2.5) * t1 / time * (t1 - time) / (1 - lambda2 * lambda3) + 1;
+    T const between0 = std::pow(time / t0, std::log(T(2)) / std::log(t1 / t0)) - 1;
+    T x = time >= t0 ? long0 : time < t1 ? short0 : between0;
+
+    // The time of flight falls monotonically in x, and equals t0 at x = 0, which brackets the root:
+    T lower = time >= t0 ? T(-1) : T(0);
+    T upper = time >= t0 ? T(0) : std::numeric_limits<T>::infinity();
+
+    // Householder's iteration on the time of flight, with the derivatives after Izzo, eq. 22. Invalid times of
+    // flight give NaN already, so they are not iterated:
+    bool converged = std::isnan(time);
+    for (std::size_t iteration = 0; iteration < lambertIterations() && !converged; iteration++)
+    {
+        T const tx = lambertTimeOfFlight(x, lambda);
+        T const umx2 = 1 - x * x;
+        T const y = std::sqrt(1 - lambda2 * umx2);
+        T const dt = (3 * tx * x - 2 + 2 * lambda3 * x / y) / umx2;
+        T const ddt = (3 * tx + 5 * x * dt + 2 * (1 - lambda2) * lambda3 / (y * y * y)) / umx2;
+        T const dddt = (7 * x * ddt + 8 * dt - 6 * (1 - lambda2) * lambda2 * lambda3 * x / (y * y * y * y * y)) / umx2;
+        T const delta = tx - time;
+        T const dt2 = dt * dt;
+        T const step = delta * (dt2 - delta * ddt / 2) / (dt * (dt2 - delta * ddt) + dddt * delta * delta / 6);
+
+        // Each evaluation narrows the bracket:
+        (delta > 0 ? lower : upper) = x;
+
+        // Converged steps may divide 0 by 0. Near lambda = ±1 the time of flight bends sharply at x = 0, where steps
+        // overshoot and may oscillate, so steps leaving the bracket bisect it instead:
+        T const next = delta != 0 ? x - step : x;
+        T const bisected = upper < std::numeric_limits<T>::infinity() ? (lower + upper) / 2 : 2 * lower + 1;
+        converged = std::abs(next - x) <= lambertTolerance() * (1 + std::abs(x));
+        x = converged || (next > lower && next < upper) ? next : bisected;
+    }
+    x = converged ? x : std::numeric_limits<T>::quiet_NaN();
+
+    // Radial and tangential velocities at both ends, Izzo, algorithm 1:
+    T const gamma = std::sqrt(mu * s / 2);
+    T const rho = (R1 - R2) / c;
+    T const sigma = std::sqrt(std::max(1 - rho * rho, T(0)));
+    T const y = std::sqrt(1 - lambda2 + lambda2 * x * x);
+    T const vr1 = gamma * ((lambda * y - x) - rho * (lambda * y + x)) / R1;
+    T const vr2 = -gamma * ((lambda * y - x) + rho * (lambda * y + x)) / R2;
+    T const vt = gamma * sigma * (y + lambda * x);
+    T const vt1 = vt / R1;
+    T const vt2 = vt / R2;
+
+    // Tangential directions are counterclockwise perpendicular to the radial ones:
+    v1x = (vr1 * r1x - vt1 * r1y) / R1;
+    v1y = (vr1 * r1y + vt1 * r1x) / R1;
+    v2x = (vr2 * r2x - vt2 * r2y) / R2;
+    v2y = (vr2 * r2y + vt2 * r2x) / R2;
+}
+
+/**
+ * Velocities of a transfer found by `lambert()`.
+ */
+template<class T>
+struct LambertTransfer
+{
+    tvec<T> departure;      ///< [m/s]  Velocity at the departure position
+    tvec<T> arrival;        ///< [m/s]  Velocity at the arrival position
+};
+
+/**
+ * Solve Lambert's problem, see `lambertSolve()`.
+ * @param mu [m³/s²] Gravitational parameter of the central body.
+ * @param r1 [m] Departure position, relative to the central body.
+ * @param r2 [m] Arrival position, relative to the central body.
+ * @param tof [s] Time of flight, must be positive.
+ * @return Departure and arrival velocities, counterclockwise.
+ */
+template<class T>
+LambertTransfer<T>
+lambert(
+        T const mu,
+        tvec<T> const &r1,
+        tvec<T> const &r2,
+        T const tof
+)
+{
+    assert(tof > 0);
+    LambertTransfer<T> transfer;
+    lambertSolve(mu, r1.x, r1.y, r2.x, r2.y, tof, transfer.departure.x, transfer.departure.y, transfer.arrival.x,
+            transfer.arrival.y);
+    return transfer;
+}
+
+/**
+ * Solve many of Lambert's problems around the same central body at once, see `lambertSolve()`.
+ *
+ * Problems are passed as one array per argument, with positions and velocities as arrays of vectors, i.e. x and y
+ * interleaved, and solved one after the other. They take different counts of iterations to converge, so the loop is
+ * not vectorized.
+ *
+ * @param mu [m³/s²] Gravitational parameter of the central body.
+ * @param r1 [m] Departure positions.
+ * @param r2 [m] Arrival positions.
+ * @param tof [s] Times of flight. Transfers not taking positive time give NaN velocities.
+ * @param v1 Receives the departure velocities.
+ * @param v2 Receives the arrival velocities.
+ */
+template<class T>
+void
+lambertBatch(
+        T const mu,
+        Span<tvec<T> const> const r1,
+        Span<tvec<T> const> const r2,
+        Span<T const> const tof,
+        Span<tvec<T>> const v1,
+        Span<tvec<T>> const v2
+)
+{
+    std::size_t const n = r1.size();
+    assert(r2.size() == n && tof.size() == n && v1.size() == n && v2.size() == n);
+    tvec<T> const *const pr1 = r1.data();
+    tvec<T> const *const pr2 = r2.data();
+    T const *const ptof = tof.data();
+    tvec<T> *const pv1 = v1.data();
+    tvec<T> *const pv2 = v2.data();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        lambertSolve(mu, pr1[i].x, pr1[i].y, pr2[i].x, pr2[i].y, ptof[i], pv1[i].x, pv1[i].y, pv2[i].x, pv2[i].y);
+    }
+}
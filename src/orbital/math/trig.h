@@ -0,0 +1,106 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+/**
+ * Sine and cosine of the same angle.
+ */
+template<class T>
+struct SinCos
+{
+    T sin;
+    T cos;
+};
+
+/**
+ * Trigonometry policy using the standard library, precise to the last bit. Used by physics and by default.
+ */
+struct PreciseTrig
+{
+
+    /**
+     * Compute sine and cosine together. Compilers fuse both calls into a single `sincos()`, sharing range reduction.
+     * @param x Angle in radian.
+     * @return Sine and cosine of x.
+     */
+    template<class T>
+    static SinCos<T>
+    sincos(
+            T const x
+    )
+    {
+        return {std::sin(x), std::cos(x)};
+    }
+
+};
+
+/**
+ * Trigonometry policy trading precision for speed, for rendering.
+ *
+ * The angle is reduced to \f$ r \in [-\frac{\pi}{4}, \frac{\pi}{4}] \f$ by subtracting a multiple of
+ * \f$ \frac{\pi}{2} \f$ in two parts (Cody-Waite), then sine and cosine of r are evaluated by minimax polynomials of
+ * degree 7 and 8 (Cephes' single precision coefficients) and swapped or negated according to the quadrant.
+ * The quadrant is selected by computed masks rather than branches, so loops using it vectorize, given the target has
+ * vector rounding instructions (SSE 4.1 or later) and the compiler may round without `errno`, i.e. `-fno-math-errno`.
+ * Both are given by the `ORBITAL_NATIVE` CMake option.
+ */
+struct FastTrig
+{
+
+    /**
+     * @return Bound for the absolute error of sine and cosine in double precision, for angles within
+     * \f$ [-10^6, 10^6] \f$. Single precision is bound by its own rounding instead.
+     */
+    static constexpr double
+    maxError()
+    {
+        return 1e-8;
+    }
+
+    /**
+     * Compute approximate sine and cosine together.
+     * @param x Angle in radian. Beyond \f$ [-10^6, 10^6] \f$ the error grows with the angle. NaN and infinity give
+     * NaN.
+     * @return Sine and cosine of x, within `maxError()`.
+     */
+    template<class T>
+    static SinCos<T>
+    sincos(
+            T const x
+    )
+    {
+        static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "FastTrig supports float and double");
+
+        // π/2 split into a part exactly multipliable by small integers, and the remainder, which differ by precision:
+        constexpr bool single = std::is_same_v<T, float>;
+        T const halfPiHigh = single ? 1.5703125 : 1.57079632673412561417e+00;
+        T const halfPiLow = single ? 4.83826794897e-4 : 6.07710050650619224932e-11;
+        T const twoByPi = 6.36619772367581382433e-01;
+
+        T const k = std::nearbyint(x * twoByPi);
+        T const r = (x - k * halfPiHigh) - k * halfPiLow;
+        T const z = r * r;
+
+        T const s = ((T(-1.9515295891e-4) * z + T(8.3321608736e-3)) * z - T(1.6666654611e-1)) * z * r + r;
+        T const c = ((T(2.443315711809948e-5) * z - T(1.388731625493765e-3)) * z + T(4.166664568298827e-2)) * z * z -
+                T(0.5) * z + T(1);
+
+        // Quadrant as k mod 4 within [-2, 2] in floating point, since converting k itself to int overflows beyond
+        // |x| of about 3e9. Rounding rather than std::floor() keeps the loop vectorizable. Masking the low bits of a
+        // negative remainder gives the same quadrant. Infinite and NaN angles give a NaN remainder, which is replaced,
+        // as converting it is undefined too:
+        T const remainder = k - 4 * std::nearbyint(k / 4);
+        auto const quadrant = static_cast<int>(remainder == remainder ? remainder : T(0));
+
+        // Odd quadrants swap sine and cosine, sine is negated in quadrants 2 and 3, cosine in quadrants 1 and 2:
+        T const sin = quadrant & 1 ? c : s;
+        T const cos = quadrant & 1 ? s : c;
+        return {quadrant & 2 ? -sin : sin, (quadrant + 1) & 2 ? -cos : cos};
+    }
+
+};
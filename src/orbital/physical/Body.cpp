@@ -67,6 +67,29 @@ Body::getPosition() const
     return mPosition;
 }
 
+void
+Body::setPosition(
+        vec const &position
+)
+{
+    mPosition = position;
+}
+
+OrbitalState
+Body::orbitalState(
+        Decimal const M
+) const
+{
+    vec const p = mTrajectory.projection(mPosition - mTrajectoryCenter);
+    vec const position = p + mTrajectoryCenter;
+
+    // Ellipse tangent is perpendicular on its gradient (x/a², y/b²):
+    auto const a = mTrajectory.a();
+    auto const b = mTrajectory.b();
+    vec const direction = glm::normalize(vec{-p.y / (b * b), p.x / (a * a)});
+    return {position, direction * std::sqrt(G() * M * (2 / length(position) - 1 / a))};
+}
+
 Ellipse<Decimal> const &
 Body::getTrajectory() const
 {
@@ -7,6 +7,15 @@
 #include <orbital/common/common.h>
 #include <orbital/math/Ellipse.h>
 
+/**
+ * Position and velocity of a body, relative to the central body.
+ */
+struct OrbitalState
+{
+    vec position;   ///< [m]
+    vec velocity;   ///< [m/s]
+};
+
 class Body
 {
 
@@ -37,6 +46,26 @@ public:
     const vec &
     getPosition() const;
 
+    /**
+     * Overwrite the position, e.g. by an integrator not bound to the trajectory.
+     * @param position [m] Position relative to the central body.
+     */
+    void
+    setPosition(
+            vec const &position
+    );
+
+    /**
+     * Give the state of the body on its trajectory, to start integrating from. The position is projected onto the
+     * trajectory, the velocity is tangent to it, counterclockwise, by the vis-viva equation.
+     * @param M [kg] Mass of the central body.
+     * @return State relative to the central body.
+     */
+    OrbitalState
+    orbitalState(
+            Decimal M
+    ) const;
+
     const Ellipse<Decimal> &
     getTrajectory() const;
 
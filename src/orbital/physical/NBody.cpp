@@ -0,0 +1,985 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "NBody.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include "fmt/format.h"
+#include <orbital/common/SmallVector.h>
+#include <orbital/common/trace.h>
+#include <orbital/math/hilbert.h>
+#include <orbital/math/kepler.h>
+
+/**
+ * Butcher tableau of an embedded Runge-Kutta pair. Gravity does not depend on time, so the stage times are left out.
+ */
+struct RungeKuttaTableau
+{
+    std::size_t stages;
+    std::size_t denseStages;    ///< Stages including the derivative at the new state and extra dense output stages
+    std::size_t order;          ///< Order of the error estimate, which controls the substep size
+    bool fsal;                  ///< True, if the last stage is evaluated at the new state
+    bool corrected;             ///< True, if the error estimate is scaled down by the ratio to a lower order estimate
+    std::size_t corrections;    ///< Count of dense output terms beyond cubic Hermite interpolation
+    Decimal a[16][15];          ///< Stage weights
+    Decimal b[12];              ///< Weights of the propagated solution
+    Decimal e[12];              ///< Weights of the error estimate, difference of two solutions
+    Decimal e3[12];             ///< Weights of the lower order error estimate, if corrected
+    Decimal d[4][16];           ///< Weights of the dense output terms beyond cubic Hermite interpolation
+};
+
+namespace
+{
+
+/**
+ * Dormand & Prince, "A family of embedded Runge-Kutta formulae", 1980. Dense output of 4th order after Hairer, Nørsett
+ * & Wanner, "Solving Ordinary Differential Equations I", section II.6.
+ */
+constexpr RungeKuttaTableau dormandPrince5{
+        7, 7, 4, true, false, 1,
+        {
+                {},
+                {1.0 / 5},
+                {3.0 / 40, 9.0 / 40},
+                {44.0 / 45, -56.0 / 15, 32.0 / 9},
+                {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729},
+                {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656},
+                {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84}
+        },
+        {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84, 0},
+        {71.0 / 57600, 0, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40},
+        {},
+        {
+                {-12715105075.0 / 11282082432, 0, 87487479700.0 / 32700410799, -10690763975.0 / 1880347072,
+                        701980252875.0 / 199316789632, -1453857185.0 / 822651844, 69997945.0 / 29380423}
+        }
+};
+
+/**
+ * DOP853 of Hairer, Nørsett & Wanner, "Solving Ordinary Differential Equations I", section II.10, after Dormand &
+ * Prince, "High order embedded Runge-Kutta formulae", 1981. Propagates the 8th order solution, with an error estimate
+ * of 5th order corrected by one of 3rd order, and a dense output of 7th order by three extra stages. Coefficients as
+ * given by the authors' Fortran code.
+ */
+constexpr RungeKuttaTableau dormandPrince853{
+        12, 16, 7, false, true, 4,
+        {
+                {},
+                {0.05260015195876773},
+                {0.0197250569845379, 0.0591751709536137},
+                {0.02958758547680685, 0, 0.08876275643042054},
+                {0.2413651341592667, 0, -0.8845494793282861, 0.924834003261792},
+                {0.037037037037037035, 0, 0, 0.17082860872947386, 0.12546768756682242},
+                {0.037109375, 0, 0, 0.17025221101954405, 0.06021653898045596, -0.017578125},
+                {0.03709200011850479, 0, 0, 0.17038392571223998, 0.10726203044637328, -0.015319437748624402,
+                        0.008273789163814023},
+                {0.6241109587160757, 0, 0, -3.3608926294469414, -0.868219346841726, 27.59209969944671,
+                        20.154067550477894, -43.48988418106996},
+                {0.47766253643826434, 0, 0, -2.4881146199716677, -0.590290826836843, 21.230051448181193,
+                        15.279233632882423, -33.28821096898486, -0.020331201708508627},
+                {-0.9371424300859873, 0, 0, 5.186372428844064, 1.0914373489967295, -8.149787010746927,
+                        -18.52006565999696, 22.739487099350505, 2.4936055526796523, -3.0467644718982196},
+                {2.273310147516538, 0, 0, -10.53449546673725, -2.0008720582248625, -17.9589318631188, 27.94888452941996,
+                        -2.8589982771350235, -8.87285693353063, 12.360567175794303, 0.6433927460157636},
+                {}, // The derivative at the new state
+                {0.056167502283047954, 0, 0, 0, 0, 0, 0.25350021021662483, -0.2462390374708025, -0.12419142326381637,
+                        0.15329179827876568, 0.00820105229563469, 0.007567897660545699, -0.008298},
+                {0.03183464816350214, 0, 0, 0, 0, 0.028300909672366776, 0.053541988307438566, -0.05492374857139099, 0,
+                        0, -0.00010834732869724932, 0.0003825710908356584, -0.00034046500868740456, 0.1413124436746325},
+                {-0.42889630158379194, 0, 0, 0, 0, -4.697621415361164, 7.683421196062599, 4.06898981839711,
+                        0.3567271874552811, 0, 0, 0, -0.0013990241651590145, 2.9475147891527724, -9.15095847217987}
+        },
+        {0.054293734116568765, 0, 0, 0, 0, 4.450312892752409, 1.8915178993145003, -5.801203960010585,
+                0.3111643669578199, -0.1521609496625161, 0.20136540080403034, 0.04471061572777259},
+        {0.01312004499419488, 0, 0, 0, 0, -1.2251564463762044, -0.4957589496572502, 1.6643771824549864,
+                -0.35032884874997366, 0.3341791187130175, 0.08192320648511571, -0.022355307863886294},
+        {-0.18980075407240762, 0, 0, 0, 0, 4.450312892752409, 1.8915178993145003, -5.801203960010585,
+                -0.42268232132379197, -0.1521609496625161, 0.20136540080403034, 0.022651792198360825},
+        {
+                {-8.428938276109013, 0, 0, 0, 0, 0.5667149535193777, -3.0689499459498917, 2.38466765651207,
+                        2.117034582445028, -0.871391583777973, 2.2404374302607883, 0.6315787787694688,
+                        -0.08899033645133331, 18.148505520854727, -9.194632392478356, -4.436036387594894},
+                {10.427508642579134, 0, 0, 0, 0, 242.28349177525817, 165.20045171727028, -374.5467547226902,
+                        -22.113666853125306, 7.733432668472264, -30.674084731089398, -9.332130526430229,
+                        15.697238121770845, -31.139403219565178, -9.35292435884448, 35.81684148639408},
+                {19.985053242002433, 0, 0, 0, 0, -387.0373087493518, -189.17813819516758, 527.8081592054236,
+                        -11.57390253995963, 6.8812326946963, -1.0006050966910838, 0.7777137798053443,
+                        -2.778205752353508, -60.19669523126412, 84.32040550667716, 11.99229113618279},
+                {-25.69393346270375, 0, 0, 0, 0, -154.18974869023643, -231.5293791760455, 357.6391179106141,
+                        93.40532418362432, -37.45832313645163, 104.0996495089623, 29.8402934266605, -43.53345659001114,
+                        96.32455395918828, -39.17726167561544, -149.72683625798564}
+        }
+
+};
+
+}
+
+Integrator
+integratorFromName(
+        std::string_view const name
+)
+{
+    if ("projection" == name)
+    {
+        return Integrator::Projection;
+    }
+    if ("leapfrog" == name)
+    {
+        return Integrator::Leapfrog;
+    }
+    if ("yoshida4" == name)
+    {
+        return Integrator::Yoshida4;
+    }
+    if ("yoshida6" == name)
+    {
+        return Integrator::Yoshida6;
+    }
+    if ("wisdom-holman" == name)
+    {
+        return Integrator::WisdomHolman;
+    }
+    if ("dormand-prince5" == name)
+    {
+        return Integrator::DormandPrince5;
+    }
+    if ("dormand-prince853" == name)
+    {
+        return Integrator::DormandPrince853;
+    }
+    throw std::runtime_error{fmt::format("Unknown integrator {}", name)};
+}
+
+NBody::NBody(
+        Decimal const centralMass,
+        Span<Decimal const> const masses,
+        Span<vec const> const positions,
+        Span<vec const> const velocities
+)
+{
+    assert(masses.size() == positions.size() && masses.size() == velocities.size());
+    auto const n = masses.size() + 1;
+    mMass.resize(n);
+    mState.resize(4 * n);
+    mAcceleration.resize(2 * n);
+    mSlot.resize(n);
+    mIndex.resize(n);
+    std::iota(mSlot.begin(), mSlot.end(), 0);
+    std::iota(mIndex.begin(), mIndex.end(), 0);
+
+    // Move the barycenter to the origin, and bring it to rest:
+    mMass[0] = centralMass;
+    mTotalMass = centralMass;
+    vec momentum{};
+    vec moment{};
+    for (std::size_t i = 1; i < n; i++)
+    {
+        mMass[i] = masses.data()[i - 1];
+        mTotalMass += mMass[i];
+        moment += positions.data()[i - 1] * mMass[i];
+        momentum += velocities.data()[i - 1] * mMass[i];
+    }
+    vec const x0 = -moment / mTotalMass;
+    vec const v0 = -momentum / mTotalMass;
+    x()[0] = x0.x;
+    y()[0] = x0.y;
+    vx()[0] = v0.x;
+    vy()[0] = v0.y;
+    for (std::size_t i = 1; i < n; i++)
+    {
+        x()[i] = positions.data()[i - 1].x + x0.x;
+        y()[i] = positions.data()[i - 1].y + x0.y;
+        vx()[i] = velocities.data()[i - 1].x + v0.x;
+        vy()[i] = velocities.data()[i - 1].y + v0.y;
+    }
+}
+
+std::size_t
+NBody::step(
+        Integrator const integrator,
+        Decimal const dt,
+        std::size_t const threads
+)
+{
+    TRACE_ZONE("NBody::step");
+
+    // Composition coefficients, see Yoshida, "Construction of higher order symplectic integrators", 1990:
+    static Decimal const yoshida4W1 = 1 / (2 - std::cbrt(2.0_df));
+    static Decimal const yoshida4W0 = 1 - 2 * yoshida4W1;
+    static Decimal const yoshida6W[] = {
+            0.784513610477560_df, 0.235573213359357_df, -1.17767998417887_df,
+            1 - 2 * (0.784513610477560_df + 0.235573213359357_df - 1.17767998417887_df)};
+
+    // Cached accelerations, derivatives and substep sizes differ by integrator:
+    if (integrator != mIntegrator)
+    {
+        mAccelerated = false;
+        mDifferentiated = false;
+        mStepSize = 0;
+        mIntegrator = integrator;
+    }
+    mSubsteps = 0;
+
+    // Invariants are measured by the last substep of each scheme, along with its last force evaluation:
+    Measurement measurement;
+    Measurement *const measuring = mDiagnosing ? &measurement : nullptr;
+    std::size_t iterations = 0;
+    switch (integrator)
+    {
+        case Integrator::Leapfrog:
+            leapfrog(dt, threads, measuring);
+            break;
+        case Integrator::Yoshida4:
+            leapfrog(yoshida4W1 * dt, threads);
+            leapfrog(yoshida4W0 * dt, threads);
+            leapfrog(yoshida4W1 * dt, threads, measuring);
+            break;
+        case Integrator::Yoshida6:
+            for (auto const w : {yoshida6W[0], yoshida6W[1], yoshida6W[2], yoshida6W[3], yoshida6W[2], yoshida6W[1]})
+            {
+                leapfrog(w * dt, threads);
+            }
+            leapfrog(yoshida6W[0] * dt, threads, measuring);
+            break;
+        case Integrator::WisdomHolman:
+            iterations = wisdomHolman(dt, threads, measuring);
+            break;
+        case Integrator::DormandPrince5:
+            rungeKutta(dormandPrince5, mTime, dt, threads, measuring);
+            break;
+        case Integrator::DormandPrince853:
+            rungeKutta(dormandPrince853, mTime, dt, threads, measuring);
+            break;
+        case Integrator::Projection:
+            throw std::runtime_error{"Integrator does not step N-body states"};
+    }
+
+    // Only after stepping succeeded, so a step throwing keeps the time of the state:
+    mTime += dt;
+
+    if (measuring)
+    {
+        mInvariants = {measurement.energy.value(), measurement.angularMomentum.value()};
+    }
+    return iterations;
+}
+
+std::size_t
+NBody::size() const
+{
+    return mMass.size();
+}
+
+vec
+NBody::position(
+        std::size_t const index
+) const
+{
+    auto const i = mSlot[index];
+    return {x()[i] - x()[0], y()[i] - y()[0]};
+}
+
+vec
+NBody::velocity(
+        std::size_t const index
+) const
+{
+    auto const i = mSlot[index];
+    return {vx()[i] - vx()[0], vy()[i] - vy()[0]};
+}
+
+Decimal
+NBody::time() const
+{
+    return mTime;
+}
+
+void
+NBody::tolerance(
+        Decimal const tolerance
+)
+{
+    mTolerance = tolerance;
+}
+
+std::size_t
+NBody::substeps() const
+{
+    return mSubsteps;
+}
+
+Invariants
+NBody::measure() const
+{
+    auto const n = size();
+    Decimal const *const x = this->x();
+    Decimal const *const y = this->y();
+    Decimal const *const vx = this->vx();
+    Decimal const *const vy = this->vy();
+
+    CompensatedSum<Decimal> energy;
+    CompensatedSum<Decimal> angularMomentum;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        energy += mMass[i] * (vx[i] * vx[i] + vy[i] * vy[i]) / 2;
+        angularMomentum += mMass[i] * (x[i] * vy[i] - y[i] * vx[i]);
+        for (std::size_t j = i + 1; j < n; j++)
+        {
+            energy += -G() * mMass[i] * mMass[j] / std::hypot(x[j] - x[i], y[j] - y[i]);
+        }
+    }
+    return {energy.value(), angularMomentum.value()};
+}
+
+void
+NBody::diagnose(
+        bool const enabled
+)
+{
+    if (enabled && !mDiagnosing)
+    {
+        mReference = mInvariants = measure();
+    }
+    mDiagnosing = enabled;
+}
+
+bool
+NBody::diagnosing() const
+{
+    return mDiagnosing;
+}
+
+Invariants const &
+NBody::invariants() const
+{
+    return mInvariants;
+}
+
+Invariants
+NBody::drift() const
+{
+    return {(mInvariants.energy - mReference.energy) / std::abs(mReference.energy),
+            (mInvariants.angularMomentum - mReference.angularMomentum) / std::abs(mReference.angularMomentum)};
+}
+
+vec
+NBody::interpolatedPosition(
+        std::size_t const index,
+        Decimal const time
+) const
+{
+    assert(!mDense.empty());
+    auto const n = size();
+    auto const size4 = mState.size();
+    Decimal const theta = (time - mDenseBegin) / mDenseStep;
+    Decimal const theta1 = 1 - theta;
+
+    // Nested like \f$ r_0 + \theta (r_1 + (1 - \theta) (r_2 + \theta (r_3 + (1 - \theta) (r_4 + \dots)))) \f$:
+    auto const terms = mDense.size() / size4;
+    auto interpolate = [&](std::size_t const i) {
+        Decimal const *const r = mDense.data() + i;
+        Decimal result = r[(terms - 1) * size4];
+        for (auto term = terms - 2; term > 0; term--)
+        {
+            result = r[term * size4] + (term % 2 ? theta1 : theta) * result;
+        }
+        return r[0] + theta * result;
+    };
+    auto const i = mSlot[index];
+    return {interpolate(i) - interpolate(0), interpolate(n + i) - interpolate(n)};
+}
+
+Decimal
+NBody::locality() const
+{
+    auto const n = size();
+    if (n < 3)
+    {
+        return 0;
+    }
+    Decimal const *const x = this->x();
+    Decimal const *const y = this->y();
+    Decimal distance = 0;
+    for (std::size_t i = 2; i < n; i++)
+    {
+        distance += std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+    }
+    return distance / (n - 2);
+}
+
+bool
+NBody::reorder()
+{
+    TRACE_ZONE("NBody::reorder");
+    auto const n = size();
+    if (n < 3)
+    {
+        return false;
+    }
+    Decimal const *const x = this->x();
+    Decimal const *const y = this->y();
+
+    // Map the bounding box onto the grid of the curve, keeping the aspect ratio:
+    Decimal minX = x[1];
+    Decimal minY = y[1];
+    Decimal extent = 0;
+    for (std::size_t i = 1; i < n; i++)
+    {
+        minX = std::min(minX, x[i]);
+        minY = std::min(minY, y[i]);
+    }
+    for (std::size_t i = 1; i < n; i++)
+    {
+        extent = std::max({extent, x[i] - minX, y[i] - minY});
+    }
+    // The largest grid coordinate is rounded up to 2^32 as double, which would overflow, so stay below it:
+    Decimal const top = std::nextafter(Decimal(std::numeric_limits<std::uint32_t>::max()), Decimal(0));
+    Decimal const scale = extent > 0 ? top / extent : 0;
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> keys;
+    keys.reserve(n - 1);
+    for (std::size_t i = 1; i < n; i++)
+    {
+        keys.emplace_back(hilbertIndex(static_cast<std::uint32_t>((x[i] - minX) * scale),
+                static_cast<std::uint32_t>((y[i] - minY) * scale)), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 1; i < n; i++)
+    {
+        order[i] = keys[i - 1].second;
+    }
+
+    // Everything laid out by slot moves along, so cached accelerations, derivatives and dense output stay valid:
+    permute(mMass, order);
+    permute(mState, order);
+    permute(mAcceleration, order);
+    permute(mStages, order);
+    permute(mDense, order);
+    auto const index = mIndex;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        mIndex[i] = index[order[i]];
+        mSlot[mIndex[i]] = i;
+    }
+    return true;
+}
+
+void
+NBody::permute(
+        std::vector<Decimal> &values,
+        std::vector<std::size_t> const &order
+) const
+{
+    auto const n = size();
+    assert(0 == values.size() % n);
+    std::vector<Decimal> permuted(n);
+    for (auto array = values.begin(); array != values.end(); array += n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            permuted[i] = array[order[i]];
+        }
+        std::copy(permuted.begin(), permuted.end(), array);
+    }
+}
+
+void
+NBody::accelerate(
+        Decimal const *const state,
+        Decimal *const acceleration,
+        std::size_t const first,
+        std::size_t const threads,
+        CompensatedSum<Decimal> *const potential
+) const
+{
+    TRACE_ZONE("NBody::accelerate");
+    auto const n = size();
+    Decimal const *const x = state;
+    Decimal const *const y = state + n;
+    Decimal const *const m = mMass.data();
+
+    auto const count = n - first;
+    auto const chunks = threadCount(count, minimumInteractionsPerThread() / std::max<std::size_t>(n, 1) + 1, threads);
+    SmallVector<CompensatedSum<Decimal>, 64> potentials;
+    for (std::size_t chunk = 0; potential && chunk < chunks; chunk++)
+    {
+        potentials.emplace_back();
+    }
+
+    // Each thread sums the accelerations of its own bodies over all others, so no writes are shared. The potential
+    // energy is summed along from the same distances, if requested, where each pair is visited twice:
+    parallelChunks(mWorkers, count, chunks, [&](
+            std::size_t const begin,
+            std::size_t const end,
+            std::size_t const chunk
+    ) {
+        auto sum = [&](auto const measure) {
+            // Summed locally, since the sums of all chunks are adjacent and would share cache lines:
+            CompensatedSum<Decimal> chunkPotential;
+            for (auto i = first + begin; i < first + end; i++)
+            {
+                Decimal ax = 0;
+                Decimal ay = 0;
+                Decimal phi = 0;
+                for (std::size_t j = first; j < n; j++)
+                {
+                    Decimal const dx = x[j] - x[i];
+                    Decimal const dy = y[j] - y[i];
+                    Decimal const r2 = dx * dx + dy * dy;
+
+                    // The body itself is at distance 0, and contributes nothing:
+                    Decimal const s = r2 > 0 ? m[j] / (r2 * std::sqrt(r2)) : 0;
+                    ax += dx * s;
+                    ay += dy * s;
+                    if constexpr (decltype(measure)::value)
+                    {
+                        phi += s * r2;
+                    }
+                }
+                acceleration[i] = G() * ax;
+                acceleration[n + i] = G() * ay;
+                if constexpr (decltype(measure)::value)
+                {
+                    chunkPotential += -G() * m[i] * phi / 2;
+                }
+            }
+            if constexpr (decltype(measure)::value)
+            {
+                potentials[chunk] = chunkPotential;
+            }
+        };
+        potential ? sum(std::true_type{}) : sum(std::false_type{});
+    });
+    for (auto const &chunkPotential : potentials)
+    {
+        *potential += chunkPotential;
+    }
+    for (std::size_t i = 0; i < first; i++)
+    {
+        acceleration[i] = acceleration[n + i] = 0;
+    }
+}
+
+void
+NBody::differentiate(
+        Decimal const *const state,
+        Decimal *const derivative,
+        std::size_t const threads,
+        CompensatedSum<Decimal> *const potential
+) const
+{
+    auto const n = size();
+    std::copy(state + 2 * n, state + 4 * n, derivative);
+    accelerate(state, derivative + 2 * n, 0, threads, potential);
+}
+
+void
+NBody::kick(
+        Decimal const dt,
+        Measurement *const measurement
+)
+{
+    auto const n = size();
+    Decimal const *const a = mAcceleration.data();
+    if (!measurement)
+    {
+        Decimal *const v = vx();
+        for (std::size_t i = 0; i < 2 * n; i++)
+        {
+            v[i] += a[i] * dt;
+        }
+        return;
+    }
+
+    Decimal const *const x = this->x();
+    Decimal const *const y = this->y();
+    Decimal *const vx = this->vx();
+    Decimal *const vy = this->vy();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        vx[i] += a[i] * dt;
+        vy[i] += a[n + i] * dt;
+        measurement->energy += mMass[i] * (vx[i] * vx[i] + vy[i] * vy[i]) / 2;
+        measurement->angularMomentum += mMass[i] * (x[i] * vy[i] - y[i] * vx[i]);
+    }
+}
+
+void
+NBody::drift(
+        Decimal const dt
+)
+{
+    auto const n = size();
+    Decimal *const r = x();
+    Decimal const *const v = vx();
+    for (std::size_t i = 0; i < 2 * n; i++)
+    {
+        r[i] += v[i] * dt;
+    }
+    mAccelerated = false;
+}
+
+void
+NBody::leapfrog(
+        Decimal const dt,
+        std::size_t const threads,
+        Measurement *const measurement
+)
+{
+    if (!mAccelerated)
+    {
+        accelerate(mState.data(), mAcceleration.data(), 0, threads);
+    }
+    kick(dt / 2);
+    drift(dt);
+    accelerate(mState.data(), mAcceleration.data(), 0, threads, measurement ? &measurement->energy : nullptr);
+    mAccelerated = true;
+    kick(dt / 2, measurement);
+}
+
+void
+NBody::jump(
+        Decimal const dt
+)
+{
+    Decimal px = 0;
+    Decimal py = 0;
+    for (std::size_t i = 1, n = size(); i < n; i++)
+    {
+        px += mMass[i] * vx()[i];
+        py += mMass[i] * vy()[i];
+    }
+    Decimal const dx = px * dt / mMass[0];
+    Decimal const dy = py * dt / mMass[0];
+    for (std::size_t i = 1, n = size(); i < n; i++)
+    {
+        x()[i] += dx;
+        y()[i] += dy;
+    }
+}
+
+std::size_t
+NBody::wisdomHolman(
+        Decimal const dt,
+        std::size_t const threads,
+        Measurement *const measurement
+)
+{
+    auto const n = size();
+    Decimal *const x = this->x();
+    Decimal *const y = this->y();
+    Decimal *const vx = this->vx();
+    Decimal *const vy = this->vy();
+
+    // Interactions between planets only, the central body's attraction is part of the Kepler drift. Distances do not
+    // depend on the origin, so they are evaluated on barycentric positions:
+    if (!mAccelerated)
+    {
+        accelerate(mState.data(), mAcceleration.data(), 1, threads);
+    }
+    kick(dt / 2);
+
+    // To heliocentric positions:
+    for (std::size_t i = 1; i < n; i++)
+    {
+        x[i] -= x[0];
+        y[i] -= y[0];
+    }
+
+    jump(dt / 2);
+
+    Decimal const mu = G() * mMass[0];
+    std::atomic<std::size_t> iterations{0};
+    auto const chunks = threadCount(n - 1, minimumInteractionsPerThread() / keplerMaxIterations(), threads);
+    parallelChunks(mWorkers, n - 1, chunks, [&](
+            std::size_t const begin,
+            std::size_t const end,
+            std::size_t
+    ) {
+        TRACE_ZONE("NBody::wisdomHolman/kepler");
+        std::size_t chunkIterations = 0;
+        for (auto i = begin + 1; i < end + 1; i++)
+        {
+            auto const drifted = keplerDrift(mu, vec{x[i], y[i]}, vec{vx[i], vy[i]}, dt);
+            x[i] = drifted.position.x;
+            y[i] = drifted.position.y;
+            vx[i] = drifted.velocity.x;
+            vy[i] = drifted.velocity.y;
+            chunkIterations += drifted.iterations;
+        }
+        iterations += chunkIterations;
+    });
+
+    jump(dt / 2);
+
+    // Back to barycentric positions, keeping the barycenter in the origin and at rest:
+    Decimal mx = 0;
+    Decimal my = 0;
+    Decimal px = 0;
+    Decimal py = 0;
+    for (std::size_t i = 1; i < n; i++)
+    {
+        mx += mMass[i] * x[i];
+        my += mMass[i] * y[i];
+        px += mMass[i] * vx[i];
+        py += mMass[i] * vy[i];
+    }
+    x[0] = -mx / mTotalMass;
+    y[0] = -my / mTotalMass;
+    vx[0] = -px / mMass[0];
+    vy[0] = -py / mMass[0];
+    for (std::size_t i = 1; i < n; i++)
+    {
+        // Potential energy of the pair with the central body, from the heliocentric distance at hand:
+        if (measurement)
+        {
+            measurement->energy += -G() * mMass[0] * mMass[i] / std::hypot(x[i], y[i]);
+        }
+        x[i] += x[0];
+        y[i] += y[0];
+    }
+
+    accelerate(mState.data(), mAcceleration.data(), 1, threads, measurement ? &measurement->energy : nullptr);
+    mAccelerated = true;
+    kick(dt / 2, measurement);
+    return iterations;
+}
+
+void
+NBody::rungeKutta(
+        RungeKuttaTableau const &tableau,
+        Decimal const begin,
+        Decimal const dt,
+        std::size_t const threads,
+        Measurement *const measurement
+)
+{
+    TRACE_ZONE("NBody::rungeKutta");
+    assert(dt > 0);
+    auto const n = size();
+    auto const size4 = mState.size();
+
+    // Buffers are sized once, stepping does not allocate afterwards:
+    mStages.resize(tableau.denseStages * size4);
+    mStageState.resize(size4);
+    mNextState.resize(size4);
+    mDense.resize((4 + tableau.corrections) * size4);
+    auto stage = [&](std::size_t const s) {
+        return mStages.data() + s * size4;
+    };
+
+    // Stage from the weighted previous ones, each combination is a single pass the compiler can vectorize:
+    auto evaluate = [&](
+            Decimal const h,
+            std::size_t const s,
+            CompensatedSum<Decimal> *const energy
+    ) {
+        Decimal const *const y0 = mState.data();
+        Decimal *const ys = mStageState.data();
+        std::copy(y0, y0 + size4, ys);
+        for (std::size_t j = 0; j < s; j++)
+        {
+            Decimal const a = h * tableau.a[s][j];
+            if (0 == a)
+            {
+                continue;
+            }
+            Decimal const *const k = stage(j);
+            for (std::size_t i = 0; i < size4; i++)
+            {
+                ys[i] += a * k[i];
+            }
+        }
+        differentiate(ys, stage(s), threads, energy);
+    };
+
+    if (!mDifferentiated)
+    {
+        differentiate(mState.data(), stage(0), threads);
+        mDifferentiated = true;
+    }
+    if (0 == mStepSize)
+    {
+        mStepSize = dt;
+    }
+
+    Decimal remaining = dt;
+    std::size_t rejections = 0;
+    while (remaining > 0)
+    {
+        Decimal const h = std::min(mStepSize, remaining);
+        bool const clipped = h < mStepSize;
+        if (h <= 16 * std::numeric_limits<Decimal>::epsilon() * std::abs(dt))
+        {
+            throw std::runtime_error{"Step size underflow"};
+        }
+        mSubsteps++;
+
+        // Invariants are measured by the last substep, if accepted:
+        bool const last = h == remaining;
+        Measurement substepMeasurement;
+        Measurement *const measuring = measurement && last ? &substepMeasurement : nullptr;
+
+        // For FSAL tableaus, the last stage is evaluated at the new state:
+        Decimal const *const y0 = mState.data();
+        for (std::size_t s = 1; s < tableau.stages; s++)
+        {
+            bool const atNewState = tableau.fsal && tableau.stages - 1 == s;
+            evaluate(h, s, measuring && atNewState ? &measuring->energy : nullptr);
+        }
+
+        // Propagated solution, and error estimate in place of the stage state:
+        Decimal *const y1 = mNextState.data();
+        Decimal *const error = mStageState.data();
+        std::copy(y0, y0 + size4, y1);
+        std::fill(error, error + size4, 0);
+        for (std::size_t j = 0; j < tableau.stages; j++)
+        {
+            Decimal const b = h * tableau.b[j];
+            Decimal const e = h * tableau.e[j];
+            Decimal const *const k = stage(j);
+            for (std::size_t i = 0; i < size4; i++)
+            {
+                y1[i] += b * k[i];
+                error[i] += e * k[i];
+            }
+        }
+        if (tableau.corrected)
+        {
+            // Lower order estimate in the slot of the derivative at the new state, which is evaluated after acceptance.
+            // Where it is much larger, the error is overestimated, so it is scaled down after Hairer's DOP853 code:
+            Decimal *const lower = stage(tableau.stages);
+            std::fill(lower, lower + size4, 0);
+            for (std::size_t j = 0; j < tableau.stages; j++)
+            {
+                Decimal const e = h * tableau.e3[j];
+                Decimal const *const k = stage(j);
+                for (std::size_t i = 0; i < size4; i++)
+                {
+                    lower[i] += e * k[i];
+                }
+            }
+            for (std::size_t i = 0; i < size4; i++)
+            {
+                Decimal const scale = std::sqrt(error[i] * error[i] + Decimal(0.01) * lower[i] * lower[i]);
+                error[i] = 0 == scale ? 0 : error[i] * std::abs(error[i]) / scale;
+            }
+        }
+
+        // Largest error relative to the distance and speed of each body to the central body. The central body itself
+        // follows from the others by conservation of momentum. Kinetic energy and angular momentum are summed along:
+        Decimal norm = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            if (measuring)
+            {
+                Decimal const vx = y1[2 * n + i];
+                Decimal const vy = y1[3 * n + i];
+                measuring->energy += mMass[i] * (vx * vx + vy * vy) / 2;
+                measuring->angularMomentum += mMass[i] * (y1[i] * vy - y1[n + i] * vx);
+            }
+            if (0 == i)
+            {
+                continue;
+            }
+
+            Decimal const r = std::max(std::hypot(y0[i] - y0[0], y0[n + i] - y0[n]),
+                    std::hypot(y1[i] - y1[0], y1[n + i] - y1[n]));
+            Decimal const v = std::max(std::hypot(y0[2 * n + i] - y0[2 * n], y0[3 * n + i] - y0[3 * n]),
+                    std::hypot(y1[2 * n + i] - y1[2 * n], y1[3 * n + i] - y1[3 * n]));
+            Decimal const min = std::numeric_limits<Decimal>::min();
+            Decimal const positionError = std::hypot(error[i], error[n + i]) / (mTolerance * r + min);
+            Decimal const velocityError = std::hypot(error[2 * n + i], error[3 * n + i]) / (mTolerance * v + min);
+
+            // Unlike std::max(), NaN is kept, so the step is rejected:
+            norm = positionError > norm || std::isnan(positionError) ? positionError : norm;
+            norm = velocityError > norm || std::isnan(velocityError) ? velocityError : norm;
+        }
+
+        // Step size control after Hairer, Nørsett & Wanner, "Solving Ordinary Differential Equations I", II.4.
+        // NaN errors shrink the step by the largest factor, until it succeeds or too many rejections in a row:
+        Decimal const factor = std::isnan(norm) ? Decimal(0.2) : std::clamp(
+                Decimal(0.9) * std::pow(norm, Decimal(-1) / (tableau.order + 1)), Decimal(0.2), Decimal(5));
+        if (!(norm <= 1))
+        {
+            if (++rejections > maximumRejections())
+            {
+                throw std::runtime_error{"Too many rejected substeps"};
+            }
+            mStepSize = h * std::min(factor, Decimal(1));
+            continue;
+        }
+        rejections = 0;
+
+        // Accepted, a clipped step says little about the step size the orbit allows:
+        if (!clipped || h * factor > mStepSize)
+        {
+            mStepSize = h * factor;
+        }
+
+        // Derivative at the new state, which is the last stage already for FSAL tableaus:
+        Decimal *const k0 = stage(0);
+        Decimal *const k1 = stage(tableau.fsal ? tableau.stages - 1 : tableau.stages);
+        if (!tableau.fsal)
+        {
+            differentiate(y1, k1, threads, measuring ? &measuring->energy : nullptr);
+        }
+
+        // Dense output of the last substep only, which is the one `interpolatedPosition()` refers to. Cubic Hermite
+        // interpolation, corrected by terms of extra stages:
+        if (last)
+        {
+            for (std::size_t s = tableau.stages + 1; s < tableau.denseStages; s++)
+            {
+                evaluate(h, s, nullptr);
+            }
+
+            Decimal *const dense = mDense.data();
+            std::copy(y0, y0 + size4, dense);
+            for (std::size_t i = 0; i < size4; i++)
+            {
+                Decimal const dy = y1[i] - y0[i];
+                Decimal const hermite = h * k0[i] - dy;
+                dense[size4 + i] = dy;
+                dense[2 * size4 + i] = hermite;
+                dense[3 * size4 + i] = dy - h * k1[i] - hermite;
+            }
+            for (std::size_t c = 0; c < tableau.corrections; c++)
+            {
+                Decimal *const term = dense + (4 + c) * size4;
+                std::fill(term, term + size4, 0);
+                for (std::size_t j = 0; j < tableau.denseStages; j++)
+                {
+                    Decimal const d = h * tableau.d[c][j];
+                    if (0 == d)
+                    {
+                        continue;
+                    }
+                    Decimal const *const k = stage(j);
+                    for (std::size_t i = 0; i < size4; i++)
+                    {
+                        term[i] += d * k[i];
+                    }
+                }
+            }
+            mDenseBegin = begin + dt - remaining;
+            mDenseStep = h;
+        }
+
+        std::copy(k1, k1 + size4, k0);
+        mState.swap(mNextState);
+        remaining -= h;
+        if (measuring)
+        {
+            *measurement = substepMeasurement;
+        }
+    }
+}
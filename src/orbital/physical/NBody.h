@@ -0,0 +1,441 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <orbital/common/common.h>
+#include <orbital/common/parallel.h>
+#include <orbital/common/Span.h>
+#include <orbital/math/CompensatedSum.h>
+
+/**
+ * Scheme advancing a `System` by one time step.
+ */
+enum class Integrator
+{
+    Projection,      ///< Bodies move on their fixed trajectories, without interacting
+    Leapfrog,        ///< Kick-drift-kick leapfrog, 2nd order symplectic
+    Yoshida4,        ///< Yoshida's triple composition of leapfrog, 4th order symplectic
+    Yoshida6,        ///< Yoshida's seven-fold composition of leapfrog, 6th order symplectic
+    WisdomHolman,    ///< Wisdom-Holman mapping in democratic heliocentric coordinates, with exact Kepler drifts
+    DormandPrince5,  ///< Dormand-Prince 5(4) Runge-Kutta pair, with adaptive substeps and 4th order dense output
+    DormandPrince853 ///< Dormand-Prince 8(5,3) Runge-Kutta pair, with adaptive substeps and 7th order dense output
+};
+
+struct RungeKuttaTableau;
+
+/**
+ * Quantities conserved by the exact solution of the N-body problem, to judge the accuracy of an integration.
+ */
+struct Invariants
+{
+    Decimal energy;             ///< [J]        Kinetic and potential energy
+    Decimal angularMomentum;    ///< [kg m²/s]  Around the barycenter
+};
+
+/**
+ * Parse an integrator by its name, as used on the command line: `projection`, `leapfrog`, `yoshida4`, `yoshida6`,
+ * `wisdom-holman`, `dormand-prince5` or `dormand-prince853`.
+ * @param name Integrator name.
+ * @return Integrator.
+ * @throw std::runtime_error On unknown names.
+ */
+Integrator
+integratorFromName(
+        std::string_view name
+);
+
+/**
+ * Gravitational N-body state, integrated by symplectic schemes.
+ *
+ * All bodies attract each other, so stepping costs O(N²). Each force evaluation visits every pair from both sides,
+ * i.e. takes 2·N² interactions instead of N², traded for threads writing only the accelerations of their own bodies.
+ * State is stored as structure of arrays in barycentric coordinates, with the barycenter at rest in the origin. Body 0
+ * is the central body, positions and velocities are given and returned relative to it.
+ *
+ * Symplectic schemes do not drift in energy, but oscillate around the initial energy by an amount depending on the
+ * order and time step. For planetary systems, `Integrator::WisdomHolman` takes the largest time steps, since it
+ * integrates the dominant central body term exactly and only the small interactions between the planets approximately.
+ *
+ * Close encounters and highly eccentric orbits need small steps near periapsis only. The embedded Runge-Kutta pairs
+ * split each time step into substeps, whose size is controlled to keep the estimated error of each body's position and
+ * velocity below a tolerance relative to its distance and speed. These are not symplectic, so energy drifts slowly by
+ * an amount bound by the tolerance. Their state is updated by single passes over contiguous arrays, and buffers are
+ * allocated by the first step only.
+ *
+ * Bodies are addressed by a stable index, their order of creation. Their state is stored in another order, which
+ * `reorder()` changes to keep bodies close in space close in memory, for work visiting neighbors.
+ */
+class NBody
+{
+
+public:
+
+    /**
+     * Create a state.
+     * @param centralMass [kg] Mass of the central body.
+     * @param masses [kg] Masses of the other bodies.
+     * @param positions [m] Positions of the other bodies, relative to the central body.
+     * @param velocities [m/s] Velocities of the other bodies, relative to the central body.
+     */
+    NBody(
+            Decimal centralMass,
+            Span<Decimal const> masses,
+            Span<vec const> positions,
+            Span<vec const> velocities
+    );
+
+    /**
+     * Advance all bodies by one time step.
+     * @param integrator Scheme to use, must not be `Integrator::Projection`.
+     * @param dt [s] Time step.
+     * @param threads Maximum count of threads evaluating forces. 0 means as many as there are hardware threads.
+     * @return Count of iterations spent solving Kepler's equation.
+     * @throw std::runtime_error For `Integrator::Projection`, if a substep size underflows, or if more than
+     * `maximumRejections()` substeps in a row are rejected. `time()` stays unchanged then.
+     */
+    std::size_t
+    step(
+            Integrator integrator,
+            Decimal dt,
+            std::size_t threads
+    );
+
+    /**
+     * @return Count of bodies, including the central body.
+     */
+    std::size_t
+    size() const;
+
+    /**
+     * @param index Body index, 0 is the central body.
+     * @return [m] Position relative to the central body.
+     */
+    vec
+    position(
+            std::size_t index
+    ) const;
+
+    /**
+     * @param index Body index, 0 is the central body.
+     * @return [m/s] Velocity relative to the central body.
+     */
+    vec
+    velocity(
+            std::size_t index
+    ) const;
+
+    /**
+     * @return [s] Time integrated since creation.
+     */
+    Decimal
+    time() const;
+
+    /**
+     * Set the error tolerance of adaptive integrators.
+     * @param tolerance Largest error per substep, relative to the distance and speed of a body to the central body.
+     */
+    void
+    tolerance(
+            Decimal tolerance
+    );
+
+    /**
+     * @return Count of substeps the last step took, including rejected ones. 0 for integrators without substeps.
+     */
+    std::size_t
+    substeps() const;
+
+    /**
+     * Interpolate a position within the last substep of `Integrator::DormandPrince5` or
+     * `Integrator::DormandPrince853` by its dense output, of 4th and 7th order respectively.
+     * @attention Only valid after a step by these integrators.
+     * @param index Body index, 0 is the central body.
+     * @param time [s] Time within the last substep, see `time()`.
+     * @return [m] Position relative to the central body.
+     */
+    vec
+    interpolatedPosition(
+            std::size_t index,
+            Decimal time
+    ) const;
+
+    /**
+     * Measure the invariants of the current state by a separate pass, taking O(N²) time.
+     * @return Invariants.
+     */
+    Invariants
+    measure() const;
+
+    /**
+     * Enable or disable measuring invariants while stepping. Enabling measures the current invariants as reference for
+     * `drift()`.
+     *
+     * Measuring is fused into the last force evaluation and the last velocity update of each step, so it takes no
+     * extra pass over the bodies. Sums are compensated, so the measured drift is not dominated by rounding.
+     *
+     * @param enabled True to measure.
+     */
+    void
+    diagnose(
+            bool enabled
+    );
+
+    /**
+     * @return True, if invariants are measured while stepping.
+     */
+    bool
+    diagnosing() const;
+
+    /**
+     * @return Invariants measured by the last step, or when enabling measuring.
+     */
+    Invariants const &
+    invariants() const;
+
+    /**
+     * @return Relative changes of the invariants since measuring was enabled, e.g. \f$ \frac{E - E_0}{|E_0|} \f$.
+     */
+    Invariants
+    drift() const;
+
+    /**
+     * @return [m] Mean distance between bodies stored next to each other, excluding the central body. Grows as bodies
+     * move apart from their neighbors in memory.
+     */
+    Decimal
+    locality() const;
+
+    /**
+     * Store bodies along the Hilbert curve through their bounding box, so bodies close in space are close in memory.
+     * Body indices stay the same, this only changes where their state is stored. Takes O(N log N) time.
+     * @return True if reordered, false if there are too few bodies to be ordered.
+     */
+    bool
+    reorder();
+
+    /**
+     * @return Default error tolerance of adaptive integrators.
+     */
+    static constexpr Decimal
+    defaultTolerance()
+    {
+        return 1e-10;
+    }
+
+    /**
+     * @return Count of consecutive rejected substeps after which adaptive integrators give up. Each rejection shrinks
+     * the substep at most fivefold, so this leaves room for the first substeps of a step far too large.
+     */
+    static constexpr std::size_t
+    maximumRejections()
+    {
+        return 16;
+    }
+
+    /**
+     * @return Minimum count of pair interactions a thread evaluates, to be worth handing them to a worker.
+     */
+    static constexpr std::size_t
+    minimumInteractionsPerThread()
+    {
+        return 1u << 16u;
+    }
+
+private:
+
+    /**
+     * Partial sums of invariants, while stepping.
+     */
+    struct Measurement
+    {
+        CompensatedSum<Decimal> energy;
+        CompensatedSum<Decimal> angularMomentum;
+    };
+
+    Decimal *
+    x()
+    {
+        return mState.data();
+    }
+
+    Decimal *
+    y()
+    {
+        return mState.data() + size();
+    }
+
+    Decimal *
+    vx()
+    {
+        return mState.data() + 2 * size();
+    }
+
+    Decimal *
+    vy()
+    {
+        return mState.data() + 3 * size();
+    }
+
+    Decimal const *
+    x() const
+    {
+        return mState.data();
+    }
+
+    Decimal const *
+    y() const
+    {
+        return mState.data() + size();
+    }
+
+    Decimal const *
+    vx() const
+    {
+        return mState.data() + 2 * size();
+    }
+
+    Decimal const *
+    vy() const
+    {
+        return mState.data() + 3 * size();
+    }
+
+    /**
+     * Evaluate accelerations of all bodies.
+     * @param state State to evaluate, laid out like `mState`.
+     * @param acceleration Receives the accelerations, laid out like `mAcceleration`.
+     * @param first First body attracted, 1 skips the central body. Bodies before get no acceleration.
+     * @param threads Maximum count of threads.
+     * @param potential Receives the potential energy between the attracted bodies, if not null.
+     */
+    void
+    accelerate(
+            Decimal const *state,
+            Decimal *acceleration,
+            std::size_t first,
+            std::size_t threads,
+            CompensatedSum<Decimal> *potential = nullptr
+    ) const;
+
+    /**
+     * Evaluate the time derivative of a state, i.e. velocities and accelerations.
+     * @param state State to evaluate, laid out like `mState`.
+     * @param derivative Receives the derivative, laid out like `mState`.
+     * @param threads Maximum count of threads.
+     * @param potential Receives the potential energy, if not null.
+     */
+    void
+    differentiate(
+            Decimal const *state,
+            Decimal *derivative,
+            std::size_t threads,
+            CompensatedSum<Decimal> *potential = nullptr
+    ) const;
+
+    /**
+     * Update velocities by the accelerations.
+     * @param measurement Receives kinetic energy and angular momentum of the updated state, if not null.
+     */
+    void
+    kick(
+            Decimal dt,
+            Measurement *measurement = nullptr
+    );
+
+    void
+    drift(
+            Decimal dt
+    );
+
+    /**
+     * Kick-drift-kick leapfrog substep. Accelerations are kept from the previous substep, so each substep evaluates
+     * forces once.
+     * @param measurement Receives the invariants of the new state, if not null.
+     */
+    void
+    leapfrog(
+            Decimal dt,
+            std::size_t threads,
+            Measurement *measurement = nullptr
+    );
+
+    /**
+     * Wisdom-Holman step: half interaction kick, half jump, Kepler drift, half jump, half interaction kick.
+     * @param measurement Receives the invariants of the new state, if not null.
+     * @return Count of iterations spent solving Kepler's equation.
+     */
+    std::size_t
+    wisdomHolman(
+            Decimal dt,
+            std::size_t threads,
+            Measurement *measurement
+    );
+
+    /**
+     * Move heliocentric positions by the jump term of democratic heliocentric coordinates,
+     * \f$ \Delta Q = \frac{\Delta t}{M_0} \sum m_j V_j \f$.
+     */
+    void
+    jump(
+            Decimal dt
+    );
+
+    /**
+     * Advance by adaptive substeps of an embedded Runge-Kutta pair, the last one clipped to end at dt.
+     * @param begin [s] Time of the current state, where the dense output of the substeps starts.
+     * @param measurement Receives the invariants of the new state, if not null.
+     * @throw std::runtime_error If the substep size underflows, or after more than `maximumRejections()` rejected
+     * substeps in a row. Substeps accepted until then are kept.
+     */
+    void
+    rungeKutta(
+            RungeKuttaTableau const &tableau,
+            Decimal begin,
+            Decimal dt,
+            std::size_t threads,
+            Measurement *measurement
+    );
+
+    /**
+     * Move the state of bodies to their new slots.
+     * @param values Values of each body in slots, as one or more contiguous arrays of all bodies.
+     * @param order Old slot of each new slot.
+     */
+    void
+    permute(
+            std::vector<Decimal> &values,
+            std::vector<std::size_t> const &order
+    ) const;
+
+    std::vector<std::size_t> mSlot;     ///<        Slot in the state arrays of each body index
+    std::vector<std::size_t> mIndex;    ///<        Body index of each slot, the central body stays in slot 0
+    std::vector<Decimal> mMass;         ///< [kg]
+    std::vector<Decimal> mState;        ///<        x, y, vx and vy of all bodies, each contiguous. [m], [m/s]
+                                        ///<        Barycentric, positions heliocentric during Wisdom-Holman steps
+    std::vector<Decimal> mAcceleration; ///< [m/s²] ax and ay of all bodies, each contiguous
+    Decimal mTotalMass{0};              ///< [kg]
+    Decimal mTime{0};                   ///< [s]
+    Integrator mIntegrator{Integrator::Projection}; ///< Integrator of the last step
+    bool mAccelerated{false};           ///<        True, if accelerations match the current positions
+    bool mDifferentiated{false};        ///<        True, if the first stage holds the derivative of the current state
+    bool mDiagnosing{false};
+    Invariants mInvariants{};           ///<        As measured by the last step
+    Invariants mReference{};            ///<        As measured when enabling measuring
+
+    Decimal mTolerance{defaultTolerance()};
+    Decimal mStepSize{0};               ///< [s]    Substep size proposed by the last substep
+    std::size_t mSubsteps{0};
+    std::vector<Decimal> mStages;       ///<        Derivatives of all stages, each laid out like `mState`
+    std::vector<Decimal> mStageState;
+    std::vector<Decimal> mNextState;
+    std::vector<Decimal> mDense;        ///<        Coefficients of the dense output polynomial of the last substep
+    Decimal mDenseBegin{0};             ///< [s]    Begin of the last substep
+    Decimal mDenseStep{0};              ///< [s]    Size of the last substep
+
+    mutable WorkerPool mWorkers;        ///<        Threads evaluating forces, kept across steps
+
+};
@@ -0,0 +1,424 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "PatchedConics.h"
+#include "System.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <orbital/common/parallel.h>
+#include <orbital/common/SmallVector.h>
+#include <orbital/common/trace.h>
+#include <orbital/math/elementary.h>
+#include <orbital/math/kepler.h>
+
+namespace
+{
+
+Decimal const infinity = std::numeric_limits<Decimal>::infinity();
+
+/**
+ * Extremes of a Kepler orbit.
+ */
+struct Extremes
+{
+    Decimal acceleration;   ///< [m/s²] At periapsis, infinite for radial orbits
+    Decimal apoapsis;       ///< [m]    Infinite for unbound orbits
+};
+
+/**
+ * @param mu [m³/s²] Gravitational parameter of the central body.
+ * @param r [m] Position relative to the central body.
+ * @param v [m/s] Velocity relative to the central body.
+ * @return Extremes of the orbit through the state.
+ */
+Extremes
+extremes(
+        Decimal const mu,
+        vec const &r,
+        vec const &v
+)
+{
+    Decimal const h = std::abs(r.x * v.y - r.y * v.x);
+    Decimal const energy = (v.x * v.x + v.y * v.y) / 2 - mu / length(r);
+    Decimal const e = std::sqrt(std::max<Decimal>(0, 1 + 2 * energy * h * h / (mu * mu)));
+    Decimal const p = h * h / mu;
+    Decimal const periapsis = p / (1 + e);
+    return {periapsis > 0 ? mu / (periapsis * periapsis) : infinity, energy < 0 && e < 1 ? p / (1 - e) : infinity};
+}
+
+/**
+ * Least time it takes to move by a distance, starting at a speed which grows at most by an acceleration, i.e. the
+ * positive root of \f$ d = v t + \frac{a}{2} t^2 \f$.
+ * @param distance [m] Distance.
+ * @param speed [m/s] Initial speed.
+ * @param acceleration [m/s²] Largest acceleration.
+ * @return [s] Time, infinite if neither moves.
+ */
+Decimal
+leastTime(
+        Decimal const distance,
+        Decimal const speed,
+        Decimal const acceleration
+)
+{
+    // Rationalized, so it does not cancel for small accelerations:
+    Decimal const denominator = speed + std::sqrt(speed * speed + 2 * acceleration * distance);
+    return denominator > 0 ? 2 * distance / denominator : infinity;
+}
+
+}
+
+PatchedConics::PatchedConics(
+        System &system
+)
+{
+    system.foreach([this](Body &body) {
+        if (mPrimaries.empty())
+        {
+            mPrimaries.push_back({G() * body.getMass(), infinity, 0, {}, {}});
+            return;
+        }
+        auto const M = mPrimaries.front().mu / G();
+        auto const state = body.orbitalState(M);
+        auto const sphere = body.getTrajectory().a() * std::pow(body.getMass() / M, 0.4_df);
+        auto const acceleration = extremes(mPrimaries.front().mu, state.position, state.velocity).acceleration;
+        mPrimaries.push_back({G() * body.getMass(), sphere, acceleration, state.position, state.velocity});
+    });
+    for (auto const &primary : mPrimaries)
+    {
+        mPositions.push_back(primary.position);
+        mVelocities.push_back(primary.velocity);
+    }
+}
+
+std::size_t
+PatchedConics::add(
+        vec const &position,
+        vec const &velocity
+)
+{
+    std::size_t primary = 0;
+    for (std::size_t k = 1; k < mPrimaries.size(); k++)
+    {
+        if (length(position - mPositions[k]) < mPrimaries[k].sphere)
+        {
+            primary = k;
+            break;
+        }
+    }
+    mSpacecraft.emplace_back();
+    seed(mSpacecraft.back(), primary, mTime, position - mPositions[primary], velocity - mVelocities[primary]);
+    return mSpacecraft.size() - 1;
+}
+
+void
+PatchedConics::propagate(
+        Decimal const dt,
+        std::size_t const threads
+)
+{
+    TRACE_ZONE("PatchedConics::propagate");
+    assert(dt >= 0);
+    auto const end = mTime + dt;
+    auto const count = mSpacecraft.size();
+
+    // Spacecraft do not interact, so they are advanced independently:
+    std::atomic<std::size_t> switches{0};
+    parallelChunks(count, threadCount(count, minimumSpacecraftPerThread(), threads), [&](
+            std::size_t const begin,
+            std::size_t const chunkEnd,
+            std::size_t
+    ) {
+        TRACE_ZONE("PatchedConics::propagate/chunk");
+        std::size_t chunkSwitches = 0;
+        for (auto i = begin; i < chunkEnd; i++)
+        {
+            chunkSwitches += advance(mSpacecraft[i], end);
+        }
+        switches += chunkSwitches;
+    });
+    mSwitches += switches;
+
+    mTime = end;
+    for (std::size_t k = 1; k < mPrimaries.size(); k++)
+    {
+        std::tie(mPositions[k], mVelocities[k]) = bodyState(k, mTime);
+    }
+}
+
+std::size_t
+PatchedConics::advance(
+        Spacecraft &spacecraft,
+        Decimal const end
+) const
+{
+    std::size_t switches = 0;
+    Decimal t = mTime;
+
+    // State of the spacecraft relative to its primary:
+    auto state = [&](Decimal const time) {
+        return keplerDrift(mPrimaries[spacecraft.primary].mu, spacecraft.seedPosition, spacecraft.seedVelocity,
+                time - spacecraft.seedTime);
+    };
+
+    // Distance to the sphere of body k, positive before crossing it, and the least time until it can be crossed:
+    struct Gap
+    {
+        Decimal distance;   ///< [m]
+        Decimal safe;       ///< [s]
+        Decimal shortest;   ///< [s]    Shortest step to take, even if the sphere may be crossed before
+    };
+    auto gap = [&](
+            std::size_t const k,
+            Decimal const time,
+            vec const &position,
+            vec const &velocity
+    ) -> Gap {
+        auto const &body = mPrimaries[k];
+        Decimal distance = 0;
+        Decimal speed = 0;
+        Decimal acceleration = spacecraft.acceleration;
+        if (k == spacecraft.primary)
+        {
+            distance = body.sphere - length(position);
+            speed = length(velocity);
+        }
+        else
+        {
+            auto const [bodyPosition, bodyVelocity] = bodyState(k, time);
+            distance = length(position - bodyPosition) - body.sphere;
+            speed = length(velocity - bodyVelocity);
+            acceleration += body.acceleration;
+        }
+        return {distance, leastTime(distance, speed, acceleration),
+                minimumCrossingFraction() * leastTime(body.sphere, speed, acceleration)};
+    };
+
+    // Visit the spheres the current orbit can cross: Its primary's one, unless bound within, or all others:
+    auto spheres = [&](auto &&visit) {
+        if (0 != spacecraft.primary)
+        {
+            if (spacecraft.apoapsis >= mPrimaries[spacecraft.primary].sphere)
+            {
+                visit(spacecraft.primary);
+            }
+            return;
+        }
+        for (std::size_t k = 1; k < mPrimaries.size(); k++)
+        {
+            visit(k);
+        }
+    };
+
+    // Spheres far away cannot be crossed for long, so each is only checked again once it may have been crossed, or
+    // after the shortest step, if that is later:
+    struct Check
+    {
+        Decimal time;       ///< [s]    Of the last check
+        Decimal distance;   ///< [m]    At the last check
+        Decimal safe;       ///< [s]    Time before which the sphere cannot be crossed
+        Decimal due;        ///< [s]    Time of the next check
+    };
+    SmallVector<Check, 16> checks;
+    auto check = [&](
+            std::size_t const k,
+            Decimal const time,
+            vec const &position,
+            vec const &velocity
+    ) {
+        auto const sample = gap(k, time, position, velocity);
+        checks[k] = {time, sample.distance, time + sample.safe, time + std::max(sample.safe, sample.shortest)};
+        return sample.distance;
+    };
+    auto checkAll = [&]() {
+        checks.clear();
+        for (std::size_t k = 0; k < mPrimaries.size(); k++)
+        {
+            checks.push_back({t, 0, infinity, infinity});
+        }
+        spheres([&](std::size_t const k) {
+            check(k, t, spacecraft.position, spacecraft.velocity);
+        });
+    };
+
+    // Regula falsi on the bracket of a crossing, modified by the Illinois rule so both ends converge. Falls back to
+    // bisection, in case it still stalls. Returns the end past the crossing, so the new orbit starts on the right side
+    // of the sphere:
+    auto refine = [&](
+            std::size_t const k,
+            Decimal low,
+            Decimal lowGap,
+            Decimal high,
+            Decimal highGap,
+            KeplerDrift<Decimal> highState
+    ) {
+        int side = 0;
+        for (std::size_t iteration = 0; high - low > crossingTolerance(); iteration++)
+        {
+            auto middle = iteration < 32 ? (low * highGap - high * lowGap) / (highGap - lowGap) : (low + high) / 2;
+            middle = std::clamp(middle, low + crossingTolerance() / 4, high - crossingTolerance() / 4);
+            auto const middleState = state(middle);
+            auto const middleGap = gap(k, middle, middleState.position, middleState.velocity).distance;
+            if (middleGap < 0)
+            {
+                high = middle;
+                highGap = middleGap;
+                highState = middleState;
+                lowGap /= side < 0 ? 2 : 1;
+                side = -1;
+            }
+            else
+            {
+                low = middle;
+                lowGap = middleGap;
+                highGap /= side > 0 ? 2 : 1;
+                side = 1;
+            }
+        }
+        return std::make_pair(high, highState);
+    };
+
+    checkAll();
+    while (t < end)
+    {
+        Decimal next = end;
+        for (auto const &c : checks)
+        {
+            next = std::min(next, c.due);
+        }
+        auto const nextState = state(next);
+
+        // Check the spheres which may have been crossed by now. If more than one was, the earliest crossing counts:
+        Decimal crossing = infinity;
+        KeplerDrift<Decimal> crossingState{};
+        std::size_t body = 0;
+        spheres([&](std::size_t const k) {
+            if (next < checks[k].safe)
+            {
+                return;
+            }
+            auto const last = checks[k];
+            auto const distance = check(k, next, nextState.position, nextState.velocity);
+            if (distance >= 0)
+            {
+                return;
+            }
+            auto const [time, timeState] = refine(k, last.time, last.distance, next, distance, nextState);
+            if (time < crossing)
+            {
+                crossing = time;
+                crossingState = timeState;
+                body = k;
+            }
+        });
+        if (0 == body)
+        {
+            t = next;
+            spacecraft.position = nextState.position;
+            spacecraft.velocity = nextState.velocity;
+            continue;
+        }
+
+        // Seed the orbit around the new primary, by the state relative to it:
+        auto const [bodyPosition, bodyVelocity] = bodyState(body, crossing);
+        if (0 == spacecraft.primary)
+        {
+            seed(spacecraft, body, crossing, crossingState.position - bodyPosition,
+                    crossingState.velocity - bodyVelocity);
+        }
+        else
+        {
+            seed(spacecraft, 0, crossing, crossingState.position + bodyPosition,
+                    crossingState.velocity + bodyVelocity);
+        }
+        switches++;
+        t = crossing;
+        checkAll();
+    }
+    return switches;
+}
+
+std::pair<vec, vec>
+PatchedConics::bodyState(
+        std::size_t const body,
+        Decimal const time
+) const
+{
+    if (0 == body)
+    {
+        return {};
+    }
+    auto const &primary = mPrimaries[body];
+    auto const state = keplerDrift(mPrimaries.front().mu, primary.position, primary.velocity, time);
+    return {state.position, state.velocity};
+}
+
+void
+PatchedConics::seed(
+        Spacecraft &spacecraft,
+        std::size_t const primary,
+        Decimal const time,
+        vec const &position,
+        vec const &velocity
+) const
+{
+    auto const orbit = extremes(mPrimaries[primary].mu, position, velocity);
+    spacecraft = {primary, time, position, velocity, orbit.acceleration, orbit.apoapsis, position, velocity};
+}
+
+Decimal
+PatchedConics::time() const
+{
+    return mTime;
+}
+
+std::size_t
+PatchedConics::size() const
+{
+    return mSpacecraft.size();
+}
+
+vec
+PatchedConics::position(
+        std::size_t const index
+) const
+{
+    auto const &spacecraft = mSpacecraft[index];
+    return spacecraft.position + mPositions[spacecraft.primary];
+}
+
+vec
+PatchedConics::velocity(
+        std::size_t const index
+) const
+{
+    auto const &spacecraft = mSpacecraft[index];
+    return spacecraft.velocity + mVelocities[spacecraft.primary];
+}
+
+std::size_t
+PatchedConics::primary(
+        std::size_t const index
+) const
+{
+    return mSpacecraft[index].primary;
+}
+
+Decimal
+PatchedConics::sphereOfInfluence(
+        std::size_t const body
+) const
+{
+    return mPrimaries[body].sphere;
+}
+
+std::size_t
+PatchedConics::switches() const
+{
+    return mSwitches;
+}
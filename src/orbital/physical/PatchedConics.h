@@ -0,0 +1,227 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <orbital/common/common.h>
+
+class System;
+
+/**
+ * Spacecraft propagated by patched conics through the bodies of a `System`.
+ *
+ * Spacecraft are massless. Each follows a Kepler orbit around the body whose sphere of influence it is in, or around
+ * the central body outside of all of them. The radius of the sphere of influence of a body of mass m on an orbit with
+ * semi-major axis a around the central mass M is Laplace's \f$ r = a (m / M)^{2/5} \f$.
+ *
+ * Bodies follow Kepler orbits around the central body, starting from their state in the system on creation. So the
+ * positions of spacecraft and bodies are known analytically at any time, by `keplerDrift()` from the last switch or
+ * from creation. Crossings of spheres of influence are found by advancing conservatively: The distance to a sphere
+ * shrinks at most by the current relative speed, which grows at most by the largest accelerations on both orbits, at
+ * their periapses. This bounds the time until the sphere can be crossed, which is large far from it. Once a crossing
+ * is bracketed, its time is refined by regula falsi, and the orbit is seeded anew from the state relative to the new
+ * primary body. Passes through a sphere taking less than `minimumCrossingFraction()` of the time to cross its radius
+ * may be missed.
+ *
+ * Propagating does not accumulate errors, since states are evaluated from their seeds directly.
+ */
+class PatchedConics
+{
+
+public:
+
+    /**
+     * Take the bodies of a system as primaries.
+     * @param system System to take bodies from, in order of `System::foreach()`.
+     */
+    explicit PatchedConics(
+            System &system
+    );
+
+    /**
+     * Add a spacecraft at the current time. Its primary is the body whose sphere of influence it is in.
+     * @param position [m] Position relative to the central body.
+     * @param velocity [m/s] Velocity relative to the central body.
+     * @return Spacecraft index.
+     */
+    std::size_t
+    add(
+            vec const &position,
+            vec const &velocity
+    );
+
+    /**
+     * Advance all spacecraft by a time step, switching their primaries on crossing spheres of influence.
+     * @param dt [s] Time step, must not be negative.
+     * @param threads Maximum count of threads. 0 means as many as there are hardware threads.
+     * @throw std::runtime_error If Kepler's equation does not converge, see `keplerDrift()`.
+     */
+    void
+    propagate(
+            Decimal dt,
+            std::size_t threads
+    );
+
+    /**
+     * @return [s] Time propagated since creation.
+     */
+    Decimal
+    time() const;
+
+    /**
+     * @return Count of spacecraft.
+     */
+    std::size_t
+    size() const;
+
+    /**
+     * @param index Spacecraft index.
+     * @return [m] Position relative to the central body.
+     */
+    vec
+    position(
+            std::size_t index
+    ) const;
+
+    /**
+     * @param index Spacecraft index.
+     * @return [m/s] Velocity relative to the central body.
+     */
+    vec
+    velocity(
+            std::size_t index
+    ) const;
+
+    /**
+     * @param index Spacecraft index.
+     * @return Index of the body the spacecraft orbits, in order of `System::foreach()`, 0 for the central body.
+     */
+    std::size_t
+    primary(
+            std::size_t index
+    ) const;
+
+    /**
+     * @param body Body index, in order of `System::foreach()`.
+     * @return [m] Radius of the body's sphere of influence, infinite for the central body.
+     */
+    Decimal
+    sphereOfInfluence(
+            std::size_t body
+    ) const;
+
+    /**
+     * @return Count of crossings of spheres of influence, by all spacecraft since creation.
+     */
+    std::size_t
+    switches() const;
+
+    /**
+     * @return [s] Precision of the times spheres of influence are crossed at.
+     */
+    static constexpr Decimal
+    crossingTolerance()
+    {
+        return 1e-3;
+    }
+
+    /**
+     * @return Shortest time step when searching for crossings, relative to the least time it can take to move by the
+     * radius of a sphere of influence.
+     */
+    static constexpr Decimal
+    minimumCrossingFraction()
+    {
+        return 0.05;
+    }
+
+    /**
+     * @return Minimum count of spacecraft a thread propagates, to be worth spawning it.
+     */
+    static constexpr std::size_t
+    minimumSpacecraftPerThread()
+    {
+        return 256;
+    }
+
+private:
+
+    /**
+     * A body, moving on a Kepler orbit around the central body.
+     */
+    struct Primary
+    {
+        Decimal mu;             ///< [m³/s²]    Gravitational parameter
+        Decimal sphere;         ///< [m]        Radius of the sphere of influence
+        Decimal acceleration;   ///< [m/s²]     Largest acceleration on its orbit, at periapsis
+        vec position;           ///< [m]        On creation, relative to the central body
+        vec velocity;           ///< [m/s]      On creation, relative to the central body
+    };
+
+    /**
+     * A spacecraft, moving on a Kepler orbit around its primary since its last switch.
+     */
+    struct Spacecraft
+    {
+        std::size_t primary;    ///<            Body index
+        Decimal seedTime;       ///< [s]        Time of the last switch, or of adding
+        vec seedPosition;       ///< [m]        At seedTime, relative to the primary
+        vec seedVelocity;       ///< [m/s]      At seedTime, relative to the primary
+        Decimal acceleration;   ///< [m/s²]     Largest acceleration on the current orbit, at periapsis
+        Decimal apoapsis;       ///< [m]        Largest distance to the primary, infinite for unbound orbits
+        vec position;           ///< [m]        At time(), relative to the primary
+        vec velocity;           ///< [m/s]      At time(), relative to the primary
+    };
+
+    /**
+     * @param body Body index.
+     * @param time [s] Time since creation.
+     * @return State of the body relative to the central body, zero for the central body.
+     */
+    std::pair<vec, vec>
+    bodyState(
+            std::size_t body,
+            Decimal time
+    ) const;
+
+    /**
+     * Seed a spacecraft's orbit around a primary.
+     * @param spacecraft Spacecraft to seed.
+     * @param primary Body index.
+     * @param time [s] Time of the state.
+     * @param position [m] Position relative to the primary.
+     * @param velocity [m/s] Velocity relative to the primary.
+     */
+    void
+    seed(
+            Spacecraft &spacecraft,
+            std::size_t primary,
+            Decimal time,
+            vec const &position,
+            vec const &velocity
+    ) const;
+
+    /**
+     * Advance a spacecraft from `time()` to a new time.
+     * @param spacecraft Spacecraft to advance.
+     * @param end [s] Time to advance to.
+     * @return Count of switches.
+     */
+    std::size_t
+    advance(
+            Spacecraft &spacecraft,
+            Decimal end
+    ) const;
+
+    std::vector<Primary> mPrimaries;    ///<            Central body first
+    std::vector<Spacecraft> mSpacecraft;
+    std::vector<vec> mPositions;        ///< [m]        Of all bodies at time(), relative to the central body
+    std::vector<vec> mVelocities;       ///< [m/s]      Of all bodies at time(), relative to the central body
+    Decimal mTime{0};                   ///< [s]
+    std::size_t mSwitches{0};
+
+};
@@ -0,0 +1,162 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "Porkchop.h"
+#include "System.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <orbital/common/parallel.h>
+#include <orbital/common/trace.h>
+#include <orbital/math/Vector.h>
+#include <orbital/math/kepler.h>
+#include <orbital/math/lambert.h>
+
+Porkchop::Porkchop(
+        System &system,
+        std::string_view const from,
+        std::string_view const to
+)
+{
+    Decimal M = 0;
+    system.foreach([&](Body &body) {
+        if (0 == M)
+        {
+            M = body.getMass();
+        }
+    });
+    mMu = G() * M;
+
+    Body const *const bodies[] = {&system.find(from), &system.find(to)};
+    for (std::size_t k = 0; k < 2; k++)
+    {
+        auto const state = bodies[k]->orbitalState(M);
+        mPositions[k] = state.position;
+        mVelocities[k] = state.velocity;
+    }
+}
+
+Porkchop::States
+Porkchop::states(
+        std::size_t const body,
+        Decimal const begin,
+        Decimal const step,
+        std::uint32_t const count
+) const
+{
+    States states;
+    states.positions.reserve(count);
+    states.velocities.reserve(count);
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        auto const state = keplerDrift(mMu, mPositions[body], mVelocities[body], begin + i * step);
+        states.positions.push_back(state.position);
+        states.velocities.push_back(state.velocity);
+    }
+    return states;
+}
+
+void
+Porkchop::row(
+        PorkchopGrid const &grid,
+        std::uint32_t const departure,
+        Span<float> const deltaV
+) const
+{
+    auto const departures = states(0, grid.departureBegin + departure * grid.departureStep, 0, 1);
+    auto const arrivals = states(1, grid.arrivalBegin, grid.arrivalStep, grid.arrivals);
+    RowBuffers buffers;
+    row({grid.departureBegin + departure * grid.departureStep, 0, 1, grid.arrivalBegin, grid.arrivalStep,
+            grid.arrivals}, 0, departures, arrivals, buffers, deltaV);
+}
+
+void
+Porkchop::row(
+        PorkchopGrid const &grid,
+        std::uint32_t const departure,
+        States const &departures,
+        States const &arrivals,
+        RowBuffers &buffers,
+        Span<float> const deltaV
+) const
+{
+    std::size_t const n = grid.arrivals;
+    assert(deltaV.size() == n);
+
+    // Lambert's problems of a row share the departure, but are batched with one array per argument anyway. Buffers
+    // only allocate for the first row of each thread:
+    Decimal const time = grid.departureBegin + departure * grid.departureStep;
+    auto &[r1, tof, v1, v2] = buffers;
+    r1.assign(n, departures.positions[departure]);
+    tof.resize(n);
+    v1.resize(n);
+    v2.resize(n);
+    for (std::size_t j = 0; j < n; j++)
+    {
+        tof[j] = grid.arrivalBegin + j * grid.arrivalStep - time;
+    }
+    lambertBatch<Decimal>(mMu, r1, arrivals.positions, tof, v1, v2);
+
+    // Each difference and its length is a single packet operation:
+    Vector2d<Decimal> const departureVelocity{departures.velocities[departure]};
+    float *const out = deltaV.data();
+    for (std::size_t j = 0; j < n; j++)
+    {
+        Decimal const excess = norm(Vector2d<Decimal>{v1[j]} - departureVelocity)
+                + norm(Vector2d<Decimal>{v2[j]} - Vector2d<Decimal>{arrivals.velocities[j]});
+        out[j] = tof[j] > 0 ? static_cast<float>(excess) : std::numeric_limits<float>::quiet_NaN();
+    }
+}
+
+void
+Porkchop::write(
+        PorkchopGrid const &grid,
+        std::ostream &out,
+        std::size_t const threads
+) const
+{
+    TRACE_ZONE("Porkchop::write");
+    auto const departures = states(0, grid.departureBegin, grid.departureStep, grid.departures);
+    auto const arrivals = states(1, grid.arrivalBegin, grid.arrivalStep, grid.arrivals);
+
+    auto const put = [&](auto const &value) {
+        out.write(reinterpret_cast<char const *>(&value), sizeof(value));
+    };
+    put(grid.departures);
+    put(grid.arrivals);
+    put(static_cast<double>(grid.departureBegin));
+    put(static_cast<double>(grid.departureStep));
+    put(static_cast<double>(grid.arrivalBegin));
+    put(static_cast<double>(grid.arrivalStep));
+
+    // Rows are independent, so each band is split among threads, then written, and its buffer reused for the next.
+    // Each chunk solves its rows in its own buffers, which are reused for all bands as well:
+    std::vector<float> band(bandRows() * grid.arrivals);
+    std::vector<RowBuffers> buffers(threadCount(bandRows(), minimumRowsPerThread(), threads));
+    for (std::uint32_t begin = 0; begin < grid.departures; begin += bandRows())
+    {
+        std::size_t const rows = std::min<std::size_t>(bandRows(), grid.departures - begin);
+        parallelChunks(rows, threadCount(rows, minimumRowsPerThread(), threads), [&](
+                std::size_t const chunkBegin,
+                std::size_t const chunkEnd,
+                std::size_t const chunk
+        ) {
+            TRACE_ZONE("Porkchop::write/chunk");
+            for (auto i = chunkBegin; i < chunkEnd; i++)
+            {
+                row(grid, static_cast<std::uint32_t>(begin + i), departures, arrivals, buffers[chunk],
+                        {band.data() + i * grid.arrivals, grid.arrivals});
+            }
+        });
+        out.write(reinterpret_cast<char const *>(band.data()),
+                static_cast<std::streamsize>(rows * grid.arrivals * sizeof(float)));
+    }
+    if (!out)
+    {
+        throw std::runtime_error("Could not write porkchop grid");
+    }
+}
@@ -0,0 +1,165 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+#include <orbital/common/common.h>
+#include <orbital/common/Span.h>
+
+class System;
+
+/**
+ * Departure and arrival dates of a porkchop plot, evenly spaced.
+ */
+struct PorkchopGrid
+{
+    Decimal departureBegin;     ///< [s]    First departure, since creation of the `Porkchop`
+    Decimal departureStep;      ///< [s]
+    std::uint32_t departures;   ///<        Count of departure dates, i.e. rows
+    Decimal arrivalBegin;       ///< [s]    First arrival, since creation of the `Porkchop`
+    Decimal arrivalStep;        ///< [s]
+    std::uint32_t arrivals;     ///<        Count of arrival dates, i.e. columns
+};
+
+/**
+ * Porkchop plots of transfers between two bodies of a `System`: The Δv of the transfer for each pair of departure and
+ * arrival dates, by `lambert()` around the central body.
+ *
+ * Bodies follow Kepler orbits around the central body, starting from their state in the system on creation, like in
+ * `PatchedConics`. Their states at all dates of a grid are evaluated once, then rows of departure dates are solved in
+ * parallel, each by `lambertBatch()` across all arrival dates.
+ *
+ * The Δv of a transfer is the sum of the hyperbolic excess speeds at both ends, i.e. relative to the bodies, so
+ * their spheres of influence are neglected. Transfers are counterclockwise, like the bodies, and take less than one
+ * revolution. Date pairs not taking positive time give NaN.
+ */
+class Porkchop
+{
+
+public:
+
+    /**
+     * Take the bodies to transfer between.
+     * @param system System to take bodies from. Its central body is the first one in order of `System::foreach()`.
+     * @param from Name of the departure body.
+     * @param to Name of the arrival body.
+     * @throw std::runtime_error If there is no such body, see `System::find()`.
+     */
+    Porkchop(
+            System &system,
+            std::string_view from,
+            std::string_view to
+    );
+
+    /**
+     * Evaluate a row of the grid.
+     * @param grid Dates to evaluate.
+     * @param departure Row, i.e. index of the departure date.
+     * @param deltaV [m/s] Receives the Δv of transfers to all arrival dates, `grid.arrivals` of them.
+     */
+    void
+    row(
+            PorkchopGrid const &grid,
+            std::uint32_t departure,
+            Span<float> deltaV
+    ) const;
+
+    /**
+     * Evaluate a grid and stream it to a binary file, in bands of `bandRows()` rows, each written once evaluated.
+     *
+     * The file holds the grid's counts of departures and arrivals as `std::uint32_t`, then its departure begin and
+     * step, and arrival begin and step as `double`, then the rows of Δv [m/s] as `float`, departure major. All in
+     * native byte order, without padding.
+     *
+     * @param grid Dates to evaluate.
+     * @param out Stream to write to, opened in binary mode.
+     * @param threads Maximum count of threads. 0 means as many as there are hardware threads.
+     * @throw std::runtime_error If writing fails.
+     */
+    void
+    write(
+            PorkchopGrid const &grid,
+            std::ostream &out,
+            std::size_t threads
+    ) const;
+
+    /**
+     * @return Count of rows evaluated before writing them.
+     */
+    static constexpr std::size_t
+    bandRows()
+    {
+        return 64;
+    }
+
+    /**
+     * @return Minimum count of rows a thread evaluates, to be worth spawning it.
+     */
+    static constexpr std::size_t
+    minimumRowsPerThread()
+    {
+        return 1;
+    }
+
+private:
+
+    /**
+     * States of a body at the dates of a grid.
+     */
+    struct States
+    {
+        std::vector<vec> positions;     ///< [m]    Relative to the central body
+        std::vector<vec> velocities;    ///< [m/s]  Relative to the central body
+    };
+
+    /**
+     * @param body Body index, 0 for departure, 1 for arrival.
+     * @param begin [s] First date.
+     * @param step [s] Time between dates.
+     * @param count Count of dates.
+     * @return States of the body.
+     */
+    States
+    states(
+            std::size_t body,
+            Decimal begin,
+            Decimal step,
+            std::uint32_t count
+    ) const;
+
+    /**
+     * Lambert's problems of a row and their solutions, reused from row to row by the same thread.
+     */
+    struct RowBuffers
+    {
+        std::vector<vec> r1;            ///< [m]    Departure position, repeated for each arrival date
+        std::vector<Decimal> tof;       ///< [s]    Time of flight to each arrival date
+        std::vector<vec> v1;            ///< [m/s]  Departure velocities
+        std::vector<vec> v2;            ///< [m/s]  Arrival velocities
+    };
+
+    /**
+     * Evaluate a row, given the states at all dates.
+     * @param buffers Buffers to solve in, resized to the count of arrival dates.
+     */
+    void
+    row(
+            PorkchopGrid const &grid,
+            std::uint32_t departure,
+            States const &departures,
+            States const &arrivals,
+            RowBuffers &buffers,
+            Span<float> deltaV
+    ) const;
+
+    Decimal mMu;        ///< [m³/s²]    Gravitational parameter of the central body
+    vec mPositions[2];  ///< [m]        Of the departure and arrival body on creation
+    vec mVelocities[2]; ///< [m/s]      Of the departure and arrival body on creation
+
+};
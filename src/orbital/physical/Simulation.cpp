@@ -0,0 +1,74 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "Simulation.h"
+#include <orbital/common/trace.h>
+
+Simulation::Simulation(
+        System &system,
+        std::chrono::steady_clock::duration const publishInterval
+)
+        : mSystem{system}
+        , mPublishInterval{publishInterval}
+{
+    // Consumers should see a valid state even before the simulation thread publishes anything:
+    mSystem.snapshot(mSnapshots.back());
+    mSnapshots.publish();
+}
+
+Simulation::~Simulation()
+{
+    stop();
+}
+
+void
+Simulation::start()
+{
+    if (mRunning.exchange(true))
+    {
+        return;
+    }
+    mThread = std::thread{&Simulation::run, this};
+}
+
+void
+Simulation::stop()
+{
+    mRunning = false;
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+Snapshot const &
+Simulation::latest()
+{
+    mSnapshots.update();
+    return mSnapshots.front();
+}
+
+void
+Simulation::run()
+{
+    auto lastPublish = std::chrono::steady_clock::now();
+
+    while (mRunning.load(std::memory_order_relaxed))
+    {
+        mSystem.stepSimulation();
+
+        auto const now = std::chrono::steady_clock::now();
+        if (now - lastPublish >= mPublishInterval)
+        {
+            TRACE_ZONE("Simulation::publish");
+            mSystem.snapshot(mSnapshots.back());
+            mSnapshots.publish();
+            lastPublish = now;
+        }
+    }
+
+    // Leave the final state visible:
+    mSystem.snapshot(mSnapshots.back());
+    mSnapshots.publish();
+}
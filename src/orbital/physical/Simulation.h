@@ -0,0 +1,82 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <orbital/common/TripleBuffer.h>
+#include "Snapshot.h"
+#include "System.h"
+
+/**
+ * Advances a system continuously on its own thread, decoupled from rendering.
+ *
+ * The simulation thread steps as fast as it can, and publishes snapshots of the system state through a lock-free
+ * triple buffer. A renderer picks up the latest snapshot at its own cadence, without ever blocking the simulation.
+ *
+ * While running, the system must not be modified by any other thread. Reading immutable body properties, like names
+ * and trajectories, is fine, but positions must be read from snapshots.
+ */
+class Simulation
+{
+
+public:
+
+    /**
+     * Create a stopped simulation.
+     * @param system System to advance.
+     * @param publishInterval Minimum wall time between two published snapshots. Publishing copies all positions, so
+     * publishing after every step would slow down small steps noticeably.
+     */
+    explicit Simulation(
+            System &system,
+            std::chrono::steady_clock::duration publishInterval = 5ms
+    );
+
+    /**
+     * Stops the simulation thread, if running.
+     */
+    ~Simulation();
+
+    Simulation(Simulation const &) = delete;
+
+    Simulation &
+    operator=(Simulation const &) = delete;
+
+    /**
+     * Start the simulation thread. Does nothing if already running.
+     */
+    void
+    start();
+
+    /**
+     * Stop the simulation thread, and wait until it has finished its current step.
+     */
+    void
+    stop();
+
+    /**
+     * Pick up the most recently published snapshot. Only call this from one consumer thread.
+     * @return Latest snapshot. Stays valid and unchanged until the next call.
+     */
+    Snapshot const &
+    latest();
+
+private:
+
+    System &mSystem;
+    std::chrono::steady_clock::duration mPublishInterval;
+    TripleBuffer<Snapshot> mSnapshots;
+    std::atomic<bool> mRunning{false};
+    std::thread mThread;
+
+    /**
+     * Simulation thread loop.
+     */
+    void
+    run();
+
+};
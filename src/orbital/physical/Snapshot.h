@@ -0,0 +1,19 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <orbital/common/common.h>
+
+/**
+ * Immutable state of a system at a point in time, as published for rendering.
+ */
+struct Snapshot
+{
+    std::uint64_t steps{0};     ///< Count of simulation steps done
+    Decimal time{0};            ///< [s]    Simulated time
+    std::vector<vec> positions; ///< [m]    Body positions, in order of `System::foreach()`
+};
@@ -3,6 +3,7 @@
 //
 
 #include "System.h"
+#include <orbital/common/trace.h>
 #include <yaml-cpp/yaml.h>
 
 System::System(
@@ -39,15 +40,169 @@ System::System(
 void
 System::stepSimulation()
 {
-    for (Body &body : mBodies)
+    TRACE_ZONE("System::stepSimulation");
+    auto const M = mCentralBody->getMass();
+
+    if (Integrator::Projection != mIntegrator)
+    {
+        if (!mNBody)
+        {
+            std::vector<Decimal> masses;
+            std::vector<vec> positions;
+            std::vector<vec> velocities;
+            for (auto const &body : mBodies)
+            {
+                auto const state = body.orbitalState(M);
+                masses.push_back(body.getMass());
+                positions.push_back(state.position);
+                velocities.push_back(state.velocity);
+            }
+            mNBody.emplace(M, masses, positions, velocities);
+            mNBody->tolerance(mTolerance);
+            mNBody->diagnose(mDiagnostics);
+            mLocality.reset();
+        }
+
+        // Measuring locality takes a pass over all bodies, and reordering them a sort, so both are amortized over many
+        // steps. Bodies in the order they were added are not ordered in space, so they are reordered right away:
+        if (0 != mReorderInterval && (!mLocality || 0 == mSteps % mReorderInterval))
+        {
+            if (!mLocality || mNBody->locality() > reorderThreshold() * *mLocality)
+            {
+                if (mNBody->reorder())
+                {
+                    mReorderCounter.add();
+                }
+                mLocality = mNBody->locality();
+            }
+        }
+        mKeplerIterationCounter.add(mNBody->step(mIntegrator, mDt, mThreads));
+        mSubstepCounter.add(mNBody->substeps());
+
+        // Central body stays in the origin:
+        for (std::size_t i = 0; i < mBodies.size(); i++)
+        {
+            mBodies[i].setPosition(mNBody->position(i + 1));
+        }
+    }
+    else
+    {
+        // Bodies only depend on the central body, so they can be stepped independently:
+        parallelChunks(mWorkers, mBodies.size(), threadCount(mBodies.size(), minimumBodiesPerThread(), mThreads), [&](
+                std::size_t const begin,
+                std::size_t const end,
+                std::size_t
+        ) {
+            TRACE_ZONE("System::stepSimulation/chunk");
+            for (auto i = begin; i < end; i++)
+            {
+                mBodies[i].step(M, mDt);
+            }
+        });
+    }
+    mSteps++;
+    mStepCounter.add();
+    mBodyStepCounter.add(mBodies.size());
+}
+
+void
+System::threads(
+        std::size_t const threads
+)
+{
+    mThreads = threads;
+}
+
+std::size_t
+System::threads() const
+{
+    return mThreads;
+}
+
+void
+System::integrator(
+        Integrator const integrator
+)
+{
+    // Bodies return to their trajectories, and start interacting from there when switching back:
+    if (Integrator::Projection == integrator)
+    {
+        mNBody.reset();
+    }
+    mIntegrator = integrator;
+}
+
+Integrator
+System::integrator() const
+{
+    return mIntegrator;
+}
+
+void
+System::diagnostics(
+        bool const enabled
+)
+{
+    mDiagnostics = enabled;
+    if (mNBody)
     {
-        body.step(mCentralBody->getMass(), mDt);
+        mNBody->diagnose(enabled);
     }
 }
 
+std::optional<Invariants>
+System::drift() const
+{
+    if (!mNBody || !mNBody->diagnosing() || Integrator::Projection == mIntegrator)
+    {
+        return std::nullopt;
+    }
+    return mNBody->drift();
+}
+
+void
+System::tolerance(
+        Decimal const tolerance
+)
+{
+    mTolerance = tolerance;
+    if (mNBody)
+    {
+        mNBody->tolerance(tolerance);
+    }
+}
+
+void
+System::reorderInterval(
+        std::uint64_t const interval
+)
+{
+    mReorderInterval = interval;
+}
+
+std::uint64_t
+System::reorderInterval() const
+{
+    return mReorderInterval;
+}
+
+Metrics &
+System::metrics()
+{
+    return mMetrics;
+}
+
+std::size_t
+System::size() const
+{
+    return mBodies.size() + (mCentralBody ? 1 : 0);
+}
+
 Body &
 System::add(const Body &body)
 {
+    // Interacting bodies are recreated with the new one on the next step:
+    mNBody.reset();
     mBodies.emplace_back(body);
     return mBodies.back();
 }
@@ -83,3 +238,36 @@ System::find(
 
     return *iter;
 }
+
+void
+System::snapshot(
+        Snapshot &snapshot
+) const
+{
+    snapshot.steps = mSteps;
+    snapshot.time = time();
+    snapshot.positions.clear();
+    snapshot.positions.push_back(mCentralBody->getPosition());
+    for (auto const &body : mBodies)
+    {
+        snapshot.positions.push_back(body.getPosition());
+    }
+}
+
+std::uint64_t
+System::steps() const
+{
+    return mSteps;
+}
+
+Decimal
+System::time() const
+{
+    return mSteps * mDt;
+}
+
+Decimal
+System::dt() const
+{
+    return mDt;
+}
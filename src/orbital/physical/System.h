@@ -5,8 +5,13 @@
 #pragma once
 
 #include "Body.h"
+#include "NBody.h"
+#include "Snapshot.h"
+#include <orbital/common/Metrics.h>
+#include <orbital/common/parallel.h>
+#include <deque>
 #include <functional>
-#include <list>
+#include <optional>
 
 /**
  * A system storing a state bound to time.
@@ -41,9 +46,135 @@ public:
     Body &
     add(const Body &body);
 
+    /**
+     * Advance all bodies by one time step.
+     * Bodies are stepped in parallel by up to `threads()` threads, if there are enough of them to be worth it.
+     */
     void
     stepSimulation();
 
+    /**
+     * Set the count of threads used for stepping.
+     * @param threads Maximum count of threads. 0 means as many as there are hardware threads.
+     */
+    void
+    threads(
+            std::size_t threads
+    );
+
+    /**
+     * @return Maximum count of threads used for stepping.
+     */
+    std::size_t
+    threads() const;
+
+    /**
+     * Select the scheme advancing bodies. With `Integrator::Projection`, bodies move on their fixed trajectories. All
+     * other integrators let bodies attract each other, starting from their current state on their trajectories.
+     * @param integrator Integrator to use for the following steps.
+     */
+    void
+    integrator(
+            Integrator integrator
+    );
+
+    /**
+     * @return Integrator used for stepping.
+     */
+    Integrator
+    integrator() const;
+
+    /**
+     * Set the error tolerance of adaptive integrators, see `NBody::tolerance()`.
+     * @param tolerance Largest error per substep, relative to the distance and speed of a body to the central body.
+     */
+    void
+    tolerance(
+            Decimal tolerance
+    );
+
+    /**
+     * Enable or disable measuring energy and angular momentum while stepping, see `NBody::diagnose()`. The drift of
+     * both tells whether the time step is small enough: Symplectic integrators keep it bounded, adaptive ones let it
+     * grow slowly, a time step too large lets it grow quickly.
+     * @param enabled True to measure.
+     */
+    void
+    diagnostics(
+            bool enabled
+    );
+
+    /**
+     * @return Relative drift of energy and angular momentum since diagnostics were enabled or bodies started
+     * interacting, or nothing if diagnostics are disabled or bodies move by `Integrator::Projection`.
+     */
+    std::optional<Invariants>
+    drift() const;
+
+    /**
+     * Set how often the storage order of interacting bodies is checked. Bodies drift apart from their neighbors in
+     * memory as they move, so when the mean distance between them grew by `reorderThreshold()` since they were last
+     * ordered, they are stored along a space-filling curve again, see `NBody::reorder()`. Names, references to bodies
+     * and the order of `foreach()` stay the same.
+     * @param interval Steps between two checks, 0 to never reorder.
+     */
+    void
+    reorderInterval(
+            std::uint64_t interval
+    );
+
+    /**
+     * @return Steps between two checks of the storage order, 0 if bodies are never reordered.
+     */
+    std::uint64_t
+    reorderInterval() const;
+
+    /**
+     * @return Count of bodies, including the central body.
+     */
+    std::size_t
+    size() const;
+
+    /**
+     * Counters of simulation work done:
+     * - `steps`: Simulation steps
+     * - `body-steps`: Bodies advanced, summed over all steps
+     * - `kepler-iterations`: Iterations spent solving Kepler's equation. Stepping by projection onto the trajectory does
+     *   not iterate, so this only counts for `Integrator::WisdomHolman`.
+     * - `substeps`: Substeps of adaptive integrators, including rejected ones
+     * - `reorders`: Times the storage order of interacting bodies was renewed
+     * @return Metrics registry.
+     */
+    Metrics &
+    metrics();
+
+    /**
+     * @return Minimum count of bodies a thread steps, to be worth spawning it.
+     */
+    static constexpr std::size_t
+    minimumBodiesPerThread()
+    {
+        return 4096;
+    }
+
+    /**
+     * @return Growth of the mean distance between bodies stored next to each other, which triggers reordering them.
+     */
+    static constexpr Decimal
+    reorderThreshold()
+    {
+        return 1.5;
+    }
+
+    /**
+     * @return Default count of steps between two checks of the storage order.
+     */
+    static constexpr std::uint64_t
+    defaultReorderInterval()
+    {
+        return 64;
+    }
+
     void
     foreach(
             std::function<void(Body &)> &&l
@@ -54,10 +185,53 @@ public:
             const std::string_view &name
     );
 
+    /**
+     * Copy the current state into a snapshot.
+     * The snapshot's memory is reused, so taking snapshots repeatedly into the same object does not allocate.
+     * @param snapshot Snapshot to overwrite.
+     */
+    void
+    snapshot(
+            Snapshot &snapshot
+    ) const;
+
+    /**
+     * @return Count of simulation steps done.
+     */
+    std::uint64_t
+    steps() const;
+
+    /**
+     * @return [s] Simulated time.
+     */
+    Decimal
+    time() const;
+
+    /**
+     * @return [s] Simulated time per step.
+     */
+    Decimal
+    dt() const;
+
 private:
 
     Decimal mDt;                 ///< [s]    Amount of time between two steps
-    std::list<Body> mBodies;
+    std::uint64_t mSteps{0};     ///<        Count of simulation steps done
+    std::size_t mThreads{1};
+    WorkerPool mWorkers;         ///<        Threads stepping bodies on their trajectories, kept across steps
+    Integrator mIntegrator{Integrator::Projection};
+    Decimal mTolerance{NBody::defaultTolerance()};
+    bool mDiagnostics{false};
+    std::optional<NBody> mNBody;    ///<        State of interacting bodies, created on the first step needing it
+    std::uint64_t mReorderInterval{defaultReorderInterval()};
+    std::optional<Decimal> mLocality;   ///< [m]    Of interacting bodies, when they were last reordered
+    std::deque<Body> mBodies;    ///<        Deque for random access, while keeping references stable on add()
+    Metrics mMetrics;
+    Counter &mStepCounter = mMetrics.counter("steps");
+    Counter &mBodyStepCounter = mMetrics.counter("body-steps");
+    Counter &mKeplerIterationCounter = mMetrics.counter("kepler-iterations");
+    Counter &mSubstepCounter = mMetrics.counter("substeps");
+    Counter &mReorderCounter = mMetrics.counter("reorders");
     std::optional<Body> mCentralBody;
 
 };
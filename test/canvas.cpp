@@ -0,0 +1,121 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <orbital/graphics/Canvas.h>
+#include <orbital/graphics/FrameWriter.h>
+
+namespace
+{
+
+/**
+ * @param path File to read.
+ * @return Whole content of the file.
+ */
+std::string
+slurp(
+        std::filesystem::path const &path
+)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+/**
+ * @param canvas Canvas to sum.
+ * @return Sum of all pixel values, divided by the full value of a pixel.
+ */
+Decimal
+coverage(
+        Canvas const &canvas
+)
+{
+    auto const pixels = canvas.pixels();
+    return std::accumulate(pixels.begin(), pixels.end(), Decimal{0}) / 255;
+}
+
+}
+
+TEST_CASE("Canvas points", "[graphics]") // NOLINT
+{
+    Canvas canvas{8, 8, Canvas::Channels::Gray};
+
+    SECTION("coverage of a point sums to 1")
+    {
+        // Each of the four pixels is rounded on its own:
+        for (auto const &location : {FramebufferVector{3.3, 4.7}, FramebufferVector{0.9, 6.1},
+                                     FramebufferVector{5.5, 5.5}})
+        {
+            canvas.clear();
+            canvas.point(canvas.mapToWorld(location));
+            CHECK(coverage(canvas) == Approx(1).margin(2 / 255.0));
+        }
+    }
+
+    SECTION("points at pixel centers cover a single pixel")
+    {
+        canvas.point(canvas.mapToWorld({2.5, 6.5}));
+        CHECK(canvas.pixels()[6 * 8 + 2] == 255);
+        CHECK(coverage(canvas) == 1);
+    }
+
+    SECTION("points are clipped at the edges")
+    {
+        // Half of the dot left of the canvas, a quarter of it beyond the bottom right corner:
+        canvas.point(canvas.mapToWorld({0, 3.5}));
+        CHECK(coverage(canvas) == Approx(0.5).margin(1 / 255.0));
+        canvas.clear();
+        canvas.point(canvas.mapToWorld({8, 8}));
+        CHECK(coverage(canvas) == Approx(0.25).margin(1 / 255.0));
+    }
+
+    SECTION("points far off the canvas are skipped")
+    {
+        std::vector<vec> const points{{1e300, -1e300}, {-1e300, 1e300}, {NAN, 0}};
+        canvas.points(points);
+        CHECK(coverage(canvas) == 0);
+    }
+}
+
+TEST_CASE("FrameWriter", "[graphics]") // NOLINT
+{
+    auto const directory = std::filesystem::temp_directory_path() / "orbital-frame-writer";
+    std::filesystem::create_directories(directory);
+
+    SECTION("grayscale frames are written as PGM")
+    {
+        Canvas canvas{3, 2, Canvas::Channels::Gray};
+        {
+            FrameWriter writer{(directory / "gray-{}").string()};
+            canvas.clear({255, 255, 255});
+            writer.write(canvas);
+            canvas.clear();
+            canvas.point(canvas.mapToWorld({1.5, 0.5}));
+            writer.write(canvas);
+            writer.flush();
+            CHECK(writer.frames() == 2);
+        }
+        CHECK(slurp(directory / "gray-0.pgm") == std::string{"P5\n3 2\n255\n"} + std::string(6, '\xff'));
+        CHECK(slurp(directory / "gray-1.pgm") == std::string{"P5\n3 2\n255\n"} + std::string{"\0\xff\0\0\0\0", 6});
+    }
+
+    SECTION("color frames are written as PPM")
+    {
+        Canvas canvas{2, 1};
+        canvas.clear({1, 2, 3});
+        canvas.color({10, 20, 30});
+        canvas.point(canvas.mapToWorld({1.5, 0.5}));
+        {
+            FrameWriter writer{(directory / "rgb-{}").string()};
+            writer.write(canvas);
+        }
+        CHECK(slurp(directory / "rgb-0.ppm") == std::string{"P6\n2 1\n255\n\1\2\3\12\24\36", 17});
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -5,6 +5,51 @@
 #include "catch/catch.hpp"
 #include <orbital/common/DynamicArray.h>
 #include <orbital/common/common.h>
+#include <orbital/math/Radian.h>
+#include <memory>
+
+static_assert(std::is_trivially_destructible_v<DynamicArray<Radian<Decimal>, 8>>);
+static_assert(!std::is_trivially_destructible_v<DynamicArray<std::string, 8>>);
+static_assert(std::is_trivially_copyable_v<DynamicArray<double, 2>>);
+static_assert(!std::is_trivially_copyable_v<DynamicArray<std::string, 2>>);
+
+namespace
+{
+
+/**
+ * Counts live instances.
+ */
+struct Tracked
+{
+    static int instances;
+
+    explicit Tracked(
+            int const value
+    )
+            : value{value}
+    {
+        instances++;
+    }
+
+    Tracked(
+            Tracked const &other
+    )
+            : value{other.value}
+    {
+        instances++;
+    }
+
+    ~Tracked()
+    {
+        instances--;
+    }
+
+    int value;
+};
+
+int Tracked::instances = 0;
+
+}
 
 TEST_CASE("DynamicArray", "[common]") // NOLINT
 {
@@ -64,5 +109,67 @@ TEST_CASE("DynamicArray", "[common]") // NOLINT
         CHECK(constantArray.back() == 5);
     }
 
-}
+    SECTION("elements are only constructed when appended, and destroyed with the array")
+    {
+        {
+            DynamicArray<Tracked, 8> tracked;
+            CHECK(Tracked::instances == 0);
+
+            tracked.emplace_back(1);
+            tracked.emplace_back(2);
+            CHECK(Tracked::instances == 2);
+
+            auto const copy = tracked;
+            CHECK(Tracked::instances == 4);
+            CHECK(copy.back().value == 2);
+
+            tracked.pop_back();
+            CHECK(Tracked::instances == 3);
+        }
+        CHECK(Tracked::instances == 0);
+    }
 
+    SECTION("moving moves elements, assigning replaces them")
+    {
+        DynamicArray<std::unique_ptr<int>, 4> pointers;
+        pointers.emplace_back(std::make_unique<int>(26));
+        auto moved = std::move(pointers);
+        CHECK(*moved[0] == 26);
+
+        DynamicArray<std::string, 4> strings{"a", "b"};
+        DynamicArray<std::string, 4> other{"c"};
+        other = strings;
+        CHECK(other.size() == 2);
+        CHECK(other.back() == "b");
+    }
+
+    SECTION("trivially copyable arrays copy their elements")
+    {
+        DynamicArray<Decimal, 2> values{1, 2};
+        auto const copy = values;
+        values.pop_back();
+        CHECK(copy.size() == 2);
+        CHECK(copy[1] == 2);
+    }
+
+    SECTION("resizing constructs and destroys elements")
+    {
+        DynamicArray<std::shared_ptr<int>, 4> pointers;
+        auto const value = std::make_shared<int>(26);
+        pointers.push_back(value);
+        pointers.resize(3);
+        CHECK(pointers.size() == 3);
+        CHECK(pointers[2] == nullptr);
+
+        pointers.resize(0);
+        CHECK(pointers.empty());
+        CHECK(value.use_count() == 1);
+    }
+
+    SECTION("empty array is usable in constant expressions")
+    {
+        constexpr DynamicArray<Decimal, 3> empty;
+        static_assert(empty.size() == 0 && empty.empty() && empty.capacity() == 3);
+    }
+
+}
@@ -6,6 +6,15 @@
 #include "common.h"
 #include <orbital/math/Ellipse.h>
 #include <orbital/math/elementary.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+// Performance critical containers copy and reorder math types bytewise:
+static_assert(std::is_trivially_copyable_v<Ellipse<Decimal>>);
+static_assert(std::is_standard_layout_v<Ellipse<Decimal>>);
+static_assert(std::is_trivially_copyable_v<Line<Decimal>>);
+static_assert(std::is_standard_layout_v<Line<Decimal>>);
 
 TEST_CASE("Ellipse", "[math]") // NOLINT
 {
@@ -223,48 +232,60 @@ TEST_CASE("Ellipse", "[math]") // NOLINT
 
     SECTION("ArcLength")
     {
-        CHECK(ellipse.arcLength(0_pi, 0_pi, 100) == Approx(0.0).margin(0.0001));
-        CHECK(ellipse.arcLength(0_pi, 0.25_pi, 1000) == Approx(1.4).margin(0.1));
-        CHECK(ellipse.arcLength(0_pi, 0.5_pi, 1000) == Approx(2.93).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, 0.75_pi, 1000) == Approx(4.47).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, 1_pi, 1000) == Approx(5.87).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, 1.25_pi, 1000) == Approx(7.27).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, 1.5_pi, 1000) == Approx(8.8).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, 1.75_pi, 1000) == Approx(10.34).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, 2_pi, 1000) == Approx(11.74).margin(0.01));
-
-        CHECK(ellipse.arcLength(1_pi, 1_pi, 100) == Approx(0.0).margin(0.0001));
-        CHECK(ellipse.arcLength(1_pi, 1.25_pi, 1000) == Approx(1.4).margin(0.1));
-        CHECK(ellipse.arcLength(1_pi, 1.5_pi, 1000) == Approx(2.93).margin(0.01));
-        CHECK(ellipse.arcLength(1_pi, 1.75_pi, 1000) == Approx(4.47).margin(0.01));
-        CHECK(ellipse.arcLength(1_pi, 2_pi, 1000) == Approx(5.87).margin(0.01));
-        CHECK(ellipse.arcLength(1_pi, 2.25_pi, 1000) == Approx(7.27).margin(0.01));
-        CHECK(ellipse.arcLength(1_pi, 2.5_pi, 1000) == Approx(8.8).margin(0.01));
-        CHECK(ellipse.arcLength(1_pi, 2.75_pi, 1000) == Approx(10.34).margin(0.01));
-        CHECK(ellipse.arcLength(1_pi, 3_pi, 1000) == Approx(11.74).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, 0_pi) == Approx(0.0).margin(0.0001));
+        CHECK(ellipse.arcLength(0_pi, 0.25_pi) == Approx(1.4).margin(0.1));
+        CHECK(ellipse.arcLength(0_pi, 0.5_pi) == Approx(2.93).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, 0.75_pi) == Approx(4.47).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, 1_pi) == Approx(5.87).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, 1.25_pi) == Approx(7.27).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, 1.5_pi) == Approx(8.8).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, 1.75_pi) == Approx(10.34).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, 2_pi) == Approx(11.74).margin(0.01));
+
+        CHECK(ellipse.arcLength(1_pi, 1_pi) == Approx(0.0).margin(0.0001));
+        CHECK(ellipse.arcLength(1_pi, 1.25_pi) == Approx(1.4).margin(0.1));
+        CHECK(ellipse.arcLength(1_pi, 1.5_pi) == Approx(2.93).margin(0.01));
+        CHECK(ellipse.arcLength(1_pi, 1.75_pi) == Approx(4.47).margin(0.01));
+        CHECK(ellipse.arcLength(1_pi, 2_pi) == Approx(5.87).margin(0.01));
+        CHECK(ellipse.arcLength(1_pi, 2.25_pi) == Approx(7.27).margin(0.01));
+        CHECK(ellipse.arcLength(1_pi, 2.5_pi) == Approx(8.8).margin(0.01));
+        CHECK(ellipse.arcLength(1_pi, 2.75_pi) == Approx(10.34).margin(0.01));
+        CHECK(ellipse.arcLength(1_pi, 3_pi) == Approx(11.74).margin(0.01));
+    }
+
+    SECTION("arc length matches numeric integration")
+    {
+        auto speed = [&](Radian<Decimal> const t) {
+            return std::sqrt(sq(ellipse.a() * t.sin()) + sq(ellipse.b() * t.cos()));
+        };
+        for (auto const te : {0.1_pi, 0.8_pi, 1.9_pi, 4.3_pi})
+        {
+            CHECK(ellipse.arcLength(0.3_pi, te).getRaw() ==
+                    Approx(integral(0.3_pi, te, 1e-12_df, speed).getRaw()).epsilon(1e-12));
+        }
     }
 
     SECTION("negative arc length")
     {
-        CHECK(ellipse.arcLength(0_pi, -0_pi, 100) == Approx(-0.0).margin(0.0001));
-        CHECK(ellipse.arcLength(0_pi, -0.25_pi, 1000) == Approx(-1.4).margin(0.1));
-        CHECK(ellipse.arcLength(0_pi, -0.5_pi, 1000) == Approx(-2.93).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, -0.75_pi, 1000) == Approx(-4.47).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, -1_pi, 1000) == Approx(-5.87).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, -1.25_pi, 1000) == Approx(-7.27).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, -1.5_pi, 1000) == Approx(-8.8).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, -1.75_pi, 1000) == Approx(-10.34).margin(0.01));
-        CHECK(ellipse.arcLength(0_pi, -2_pi, 1000) == Approx(-11.74).margin(0.01));
-
-        CHECK(ellipse.arcLength(-1_pi, -1_pi, 100) == Approx(-0.0).margin(0.0001));
-        CHECK(ellipse.arcLength(-1_pi, -1.25_pi, 1000) == Approx(-1.4).margin(0.1));
-        CHECK(ellipse.arcLength(-1_pi, -1.5_pi, 1000) == Approx(-2.93).margin(0.01));
-        CHECK(ellipse.arcLength(-1_pi, -1.75_pi, 1000) == Approx(-4.47).margin(0.01));
-        CHECK(ellipse.arcLength(-1_pi, -2_pi, 1000) == Approx(-5.87).margin(0.01));
-        CHECK(ellipse.arcLength(-1_pi, -2.25_pi, 1000) == Approx(-7.27).margin(0.01));
-        CHECK(ellipse.arcLength(-1_pi, -2.5_pi, 1000) == Approx(-8.8).margin(0.01));
-        CHECK(ellipse.arcLength(-1_pi, -2.75_pi, 1000) == Approx(-10.34).margin(0.01));
-        CHECK(ellipse.arcLength(-1_pi, -3_pi, 1000) == Approx(-11.74).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, -0_pi) == Approx(-0.0).margin(0.0001));
+        CHECK(ellipse.arcLength(0_pi, -0.25_pi) == Approx(-1.4).margin(0.1));
+        CHECK(ellipse.arcLength(0_pi, -0.5_pi) == Approx(-2.93).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, -0.75_pi) == Approx(-4.47).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, -1_pi) == Approx(-5.87).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, -1.25_pi) == Approx(-7.27).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, -1.5_pi) == Approx(-8.8).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, -1.75_pi) == Approx(-10.34).margin(0.01));
+        CHECK(ellipse.arcLength(0_pi, -2_pi) == Approx(-11.74).margin(0.01));
+
+        CHECK(ellipse.arcLength(-1_pi, -1_pi) == Approx(-0.0).margin(0.0001));
+        CHECK(ellipse.arcLength(-1_pi, -1.25_pi) == Approx(-1.4).margin(0.1));
+        CHECK(ellipse.arcLength(-1_pi, -1.5_pi) == Approx(-2.93).margin(0.01));
+        CHECK(ellipse.arcLength(-1_pi, -1.75_pi) == Approx(-4.47).margin(0.01));
+        CHECK(ellipse.arcLength(-1_pi, -2_pi) == Approx(-5.87).margin(0.01));
+        CHECK(ellipse.arcLength(-1_pi, -2.25_pi) == Approx(-7.27).margin(0.01));
+        CHECK(ellipse.arcLength(-1_pi, -2.5_pi) == Approx(-8.8).margin(0.01));
+        CHECK(ellipse.arcLength(-1_pi, -2.75_pi) == Approx(-10.34).margin(0.01));
+        CHECK(ellipse.arcLength(-1_pi, -3_pi) == Approx(-11.74).margin(0.01));
     }
 
     SECTION("bounding rect")
@@ -437,4 +458,24 @@ TEST_CASE("Ellipse", "[math]") // NOLINT
     }
      */
 
+    SECTION("value semantics")
+    {
+        std::vector<Ellipse<Decimal>> ellipses{{3, 0.5}, {1, 0.1}, {2, 0.9}};
+        std::sort(ellipses.begin(), ellipses.end(), [](auto const &lhs, auto const &rhs) {
+            return lhs.a() < rhs.a();
+        });
+        CHECK(ellipses[0].a() == 1);
+        CHECK(ellipses[1].e() == 0.9);
+        CHECK(ellipses[2].b() == Ellipse<Decimal>{3, 0.5}.b());
+
+        Ellipse<Decimal> copy;
+        std::memcpy(&copy, &ellipses[2], sizeof(copy));
+        CHECK(copy.a() == 3);
+        CHECK(copy.foci()[1] == ellipses[2].foci()[1]);
+
+        Line<Decimal> line{{0, 0}, {1, 1}};
+        line = Line<Decimal>{{1, 2}, {3, 4}};
+        CHECK(line.point(0) == vec{1, 2});
+        CHECK(line.point(1) == vec{3, 4});
+    }
 }
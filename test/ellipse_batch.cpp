@@ -0,0 +1,137 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include "common.h"
+#include <orbital/math/EllipseBatch.h>
+#include <random>
+
+TEST_CASE("EllipseBatch", "[math]") // NOLINT
+{
+    std::mt19937_64 random{7};
+    std::uniform_real_distribution<Decimal> axis{0.1, 10};
+    std::uniform_real_distribution<Decimal> eccentricity{0, 0.99};
+    std::uniform_real_distribution<Decimal> coordinate{-12, 12};
+    std::uniform_real_distribution<Decimal> parameter{0, 2 * boost::math::constants::pi<Decimal>()};
+
+    constexpr std::size_t count = 1000;
+    std::vector<Ellipse<Decimal>> ellipses;
+    std::vector<vec> points;
+    std::vector<Radian<Decimal>> ts;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        ellipses.emplace_back(axis(random), eccentricity(random));
+        points.emplace_back(coordinate(random), coordinate(random));
+        ts.emplace_back(parameter(random));
+    }
+
+    // Special cases of contains():
+    points[0] = {0, 0};
+    points[1] = {ellipses[1].a() / 2, 0};
+    points[2] = {0, -ellipses[2].b() / 2};
+
+    EllipseBatch<Decimal> batch{ellipses};
+    REQUIRE(batch.size() == count);
+
+    SECTION("members")
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            CHECK(batch[i].a() == ellipses[i].a());
+            CHECK(batch[i].b() == ellipses[i].b());
+            CHECK(batch[i].e() == ellipses[i].e());
+        }
+    }
+
+    SECTION("point")
+    {
+        std::vector<vec> result(count);
+        batch.point(ts, result);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            CHECK(result[i] == ellipses[i].point(ts[i]));
+        }
+    }
+
+    SECTION("projection")
+    {
+        std::vector<vec> result(count);
+        batch.projection(points, result);
+
+        // Projecting the origin gives nan, skip it:
+        for (std::size_t i = 1; i < count; i++)
+        {
+            CHECK(result[i] == ellipses[i].projection(points[i]));
+        }
+    }
+
+    SECTION("contains point")
+    {
+        std::vector<std::uint8_t> result(count);
+        batch.contains(points, result);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            CHECK(static_cast<bool>(result[i]) == ellipses[i].contains(points[i]));
+        }
+        CHECK(result[0]);
+        CHECK(result[1]);
+        CHECK(result[2]);
+    }
+
+    SECTION("contains rectangle")
+    {
+        Rectangle<Decimal> rect{{-0.5, -0.2}, {0.7, 0.3}};
+        std::vector<std::uint8_t> result(count);
+        batch.contains(rect, result);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            CHECK(static_cast<bool>(result[i]) == ellipses[i].contains(rect));
+        }
+    }
+
+    SECTION("pointToT")
+    {
+        std::vector<vec> onEllipse(count);
+        batch.point(ts, onEllipse);
+
+        std::vector<Radian<Decimal>> result(count);
+        batch.pointToT(onEllipse, result);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            CHECK(result[i] == ellipses[i].pointToT(onEllipse[i]));
+        }
+    }
+
+    SECTION("line intersection")
+    {
+        Line<Decimal> const line{{-12, -3}, {12, 4}};
+        std::vector<vec> first(count);
+        std::vector<vec> second(count);
+        std::vector<std::uint8_t> counts(count);
+        batch.intersectPoints(line, first, second, counts);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            auto const expected = ellipses[i].intersectPoints(line, false);
+            REQUIRE(expected.size() == counts[i]);
+            for (std::size_t j = 0; j < counts[i]; j++)
+            {
+                auto const &actual = j == 0 ? first[i] : second[i];
+                CHECK(actual.x == Approx(expected[j].x));
+                CHECK(actual.y == Approx(expected[j].y));
+            }
+        }
+    }
+
+    SECTION("boundingRect")
+    {
+        std::vector<Rectangle<Decimal>> result;
+        batch.boundingRects(result);
+        REQUIRE(result.size() == count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            CHECK(result[i].bottomLeft() == ellipses[i].boundingRect().bottomLeft());
+            CHECK(result[i].topRight() == ellipses[i].boundingRect().topRight());
+        }
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/common/FrameScheduler.h>
+
+TEST_CASE("FrameScheduler", "[common]") // NOLINT
+{
+    using Clock = FrameScheduler::Clock;
+
+    // 10 frames per second, one minute per step, one hour per second gives 6 steps per frame:
+    FrameScheduler scheduler{10, 60 * 60, 60, 2};
+    auto const start = Clock::time_point{};
+
+    SECTION("steps follow wall time")
+    {
+        CHECK(scheduler.beginFrame(start) == 6);
+        CHECK(scheduler.beginFrame(start + 100ms) == 6);
+        CHECK(scheduler.beginFrame(start + 350ms) == 15);
+    }
+
+    SECTION("fractional steps are carried over")
+    {
+        CHECK(scheduler.beginFrame(start) == 6);
+        CHECK(scheduler.beginFrame(start + 125ms) == 7);
+        CHECK(scheduler.beginFrame(start + 200ms) == 5);
+        CHECK(scheduler.beginFrame(start + 300ms) == 6);
+    }
+
+    SECTION("deadline keeps cadence")
+    {
+        scheduler.beginFrame(start);
+        CHECK(scheduler.deadline() == start + 100ms);
+        scheduler.beginFrame(start + 120ms);
+        CHECK(scheduler.deadline() == start + 200ms);
+        scheduler.beginFrame(start + 450ms);
+        CHECK(scheduler.deadline() == start + 550ms);
+    }
+
+    SECTION("backlog is limited to what fits into a frame")
+    {
+        scheduler.beginFrame(start);
+        scheduler.stepped(6, 20ms);
+        CHECK(scheduler.beginFrame(start + 100s) == 30);
+        CHECK(scheduler.beginFrame(start + 100s) == 30);
+        CHECK(scheduler.beginFrame(start + 100s) == 0);
+    }
+
+    SECTION("rendering is dropped when late")
+    {
+        scheduler.beginFrame(start);
+        CHECK(scheduler.shouldRender(start + 50ms));
+        scheduler.rendered(40ms);
+
+        scheduler.beginFrame(start + 100ms);
+        CHECK(scheduler.shouldRender(start + 150ms));
+        CHECK_FALSE(scheduler.shouldRender(start + 190ms));
+        CHECK_FALSE(scheduler.shouldRender(start + 190ms));
+        CHECK(scheduler.shouldRender(start + 190ms));
+        CHECK(scheduler.droppedFrames() == 2);
+    }
+
+    SECTION("invalid parameters are rejected")
+    {
+        CHECK_THROWS_AS(FrameScheduler(0, 60, 60), std::runtime_error);
+        CHECK_THROWS_AS(FrameScheduler(NAN, 60, 60), std::runtime_error);
+        CHECK_THROWS_AS(FrameScheduler(10, -1, 60), std::runtime_error);
+        CHECK_THROWS_AS(FrameScheduler(10, 60, 0), std::runtime_error);
+    }
+}
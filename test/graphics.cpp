@@ -0,0 +1,212 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/graphics/Graphics.h>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @param graphics Graphics to present.
+ * @return Presented frame.
+ */
+std::string
+present(
+        Graphics &graphics
+)
+{
+    std::ostringstream out;
+    graphics.present(out);
+    return out.str();
+}
+
+}
+
+TEST_CASE("Graphics points", "[graphics]") // NOLINT
+{
+    // 8 x 4 pixels, one per cell:
+    Graphics graphics{4, 8};
+
+    SECTION("points are culled at the viewport edges")
+    {
+        std::vector<vec> const points{
+                graphics.mapToWorld({0.01, 0.01}),
+                graphics.mapToWorld({7.99, 3.99}),
+                graphics.mapToWorld({-0.01, 1.5}),
+                graphics.mapToWorld({8.01, 1.5}),
+                graphics.mapToWorld({3.5, -0.01}),
+                graphics.mapToWorld({3.5, 4.01}),
+                {1e300, -1e300}
+        };
+        graphics.points(points, 'o');
+        CHECK(present(graphics) == "o       \n        \n        \n       o\n");
+        CHECK(graphics.metrics().counter("pixels").value() == 2);
+    }
+
+    SECTION("points equal single pixels")
+    {
+        std::vector<vec> points;
+        for (int i = 0; i < 600; i++)
+        {
+            points.push_back(graphics.mapToWorld({(i * 7 % 100) / 10.0 - 1, (i * 3 % 60) / 10.0 - 1}));
+        }
+        Graphics single{4, 8};
+        for (auto const &point : points)
+        {
+            single.pixel({point.x, point.y}, 'o');
+        }
+        graphics.points(points, 'o');
+        CHECK(present(graphics) == present(single));
+    }
+}
+
+TEST_CASE("Graphics braille", "[graphics]") // NOLINT
+{
+    // 2 x 4 pixels in a single cell:
+    Graphics graphics{1, 1, Graphics::Raster::Braille};
+    REQUIRE(graphics.width() == 2);
+    REQUIRE(graphics.height() == 4);
+
+    auto dot = [&](
+            Decimal const x,
+            Decimal const y
+    ) {
+        auto const world = graphics.mapToWorld({x + 0.5, y + 0.5});
+        graphics.pixel({world.x, world.y}, 'o');
+    };
+
+    SECTION("empty cells are blank")
+    {
+        CHECK(present(graphics) == " \n");
+    }
+
+    SECTION("dots map to the braille dot numbering")
+    {
+        // Dots 1, 2, 3 and 7 down the left column, 4, 5, 6 and 8 down the right one:
+        std::uint8_t const bits[4][2]{{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 2; x++)
+            {
+                graphics.clear();
+                dot(x, y);
+                int const code = 0x2800 + bits[y][x];
+                std::string const expected{static_cast<char>(0xe0 | (code >> 12)),
+                                           static_cast<char>(0x80 | ((code >> 6) & 0x3f)),
+                                           static_cast<char>(0x80 | (code & 0x3f)), '\n'};
+                CHECK(present(graphics) == expected);
+            }
+        }
+    }
+
+    SECTION("dots of a cell are combined")
+    {
+        dot(0, 0);
+        dot(1, 3);
+        CHECK(present(graphics) == "⢁\n");
+        for (int i = 0; i < 8; i++)
+        {
+            dot(i % 2, i / 2);
+        }
+        CHECK(present(graphics) == "⣿\n");
+    }
+
+    SECTION("text hides dots")
+    {
+        dot(0, 0);
+        graphics.label(graphics.mapToWorld({0.5, 0.5}), "x");
+        CHECK(present(graphics) == "x\n");
+    }
+}
+
+TEST_CASE("Graphics diffing", "[graphics]") // NOLINT
+{
+    Graphics graphics{2, 4};
+    graphics.diffing(true);
+    graphics.label(graphics.mapToWorld({0.5, 0.5}), "ab");
+
+    // First frame clears the terminal and emits all cells, parking the cursor below the frame:
+    CHECK(present(graphics) == "\x1b[2J\x1b[1;1Hab  \x1b[2;1H    \x1b[3;1H");
+
+    SECTION("unchanged frames only park the cursor")
+    {
+        CHECK(present(graphics) == "\x1b[3;1H");
+        CHECK(present(graphics) == "\x1b[3;1H");
+    }
+
+    SECTION("only changed cells are emitted")
+    {
+        graphics.label(graphics.mapToWorld({2.5, 1.5}), "c");
+        CHECK(present(graphics) == "\x1b[2;3Hc\x1b[3;1H");
+    }
+
+    SECTION("disabling and enabling again emits all cells")
+    {
+        graphics.diffing(false);
+        CHECK(present(graphics) == "ab  \n    \n");
+        graphics.diffing(true);
+        CHECK(present(graphics) == "\x1b[2J\x1b[1;1Hab  \x1b[2;1H    \x1b[3;1H");
+    }
+}
+
+TEST_CASE("Graphics density", "[graphics]") // NOLINT
+{
+    // 4 x 2 cells of 2 x 4 pixels each:
+    Graphics graphics{2, 4, Graphics::Raster::Braille};
+
+    auto cell = [&](
+            std::size_t const column,
+            std::size_t const row
+    ) {
+        auto const world = graphics.mapToWorld({column * 2 + 1.0, row * 4 + 2.0});
+        return vec{world.x, world.y};
+    };
+
+    std::vector<vec> points;
+    points.insert(points.end(), 1, cell(0, 0));
+    points.insert(points.end(), 9, cell(1, 0));
+    points.insert(points.end(), 3, cell(2, 1));
+    points.push_back(graphics.mapToWorld({-1, 2}));
+
+    SECTION("counts map linearly onto the ramp")
+    {
+        graphics.density(points);
+        CHECK(present(graphics) == ".@  \n  - \n");
+        CHECK(graphics.metrics().counter("pixels").value() == 3);
+    }
+
+    SECTION("counts map logarithmically onto the ramp")
+    {
+        graphics.density(points, Graphics::DensityScale::Logarithmic);
+        CHECK(present(graphics) == "-@  \n  * \n");
+    }
+
+    SECTION("counts of earlier frames are cleared")
+    {
+        graphics.density(points);
+        graphics.clear();
+        graphics.density(std::vector<vec>{cell(3, 1)});
+        CHECK(present(graphics) == "    \n   @\n");
+    }
+
+    SECTION("histograms of all threads are merged")
+    {
+        // Half of all points in the first cell, an eighth in each of the last four:
+        std::vector<vec> many;
+        for (std::size_t i = 0; i < 4 * Graphics::minimumDensityPointsPerThread(); i++)
+        {
+            many.push_back(i % 8 < 4 ? cell(0, 0) : cell(i % 4, 1));
+        }
+        graphics.density(many, Graphics::DensityScale::Linear, 4);
+        auto const threaded = present(graphics);
+        CHECK(threaded == "@   \n----\n");
+
+        graphics.clear();
+        graphics.density(many, Graphics::DensityScale::Linear, 1);
+        CHECK(present(graphics) == threaded);
+    }
+}
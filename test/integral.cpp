@@ -13,17 +13,17 @@ TEST_CASE("Integral", "[math]") // NOLINT
 
     SECTION("null area due same bounds results in 0")
     {
-        CHECK(integral(1_df, 1_df, 100_df, &sq) == Approx(0_df));
+        CHECK(integral(1_df, 1_df, 1e-12_df, &sq) == Approx(0_df));
     }
 
     SECTION("integrating square function")
     {
-        CHECK(integral(1_df, 2_df, 100_df, &sq) == Approx(2.33_df).margin(0.01_df));
+        CHECK(integral(1_df, 2_df, 1e-12_df, &sq) == Approx(2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating square function in opposite direction")
     {
-        CHECK(integral(2_df, 1_df, 100_df, &sq) == Approx(-2.33_df).margin(0.01_df));
+        CHECK(integral(2_df, 1_df, 1e-12_df, &sq) == Approx(-2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating negated square function")
@@ -31,7 +31,7 @@ TEST_CASE("Integral", "[math]") // NOLINT
         auto negativeSq = [](Decimal x) {
             return -x * x;
         };
-        CHECK(integral(1_df, 2_df, 100_df, negativeSq) == Approx(-2.33_df).margin(0.01_df));
+        CHECK(integral(1_df, 2_df, 1e-12_df, negativeSq) == Approx(-2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating negated square function in opposite direction")
@@ -39,17 +39,17 @@ TEST_CASE("Integral", "[math]") // NOLINT
         auto negativeSq = [](Decimal x) {
             return -x * x;
         };
-        CHECK(integral(2_df, 1_df, 100_df, negativeSq) == Approx(2.33_df).margin(0.01_df));
+        CHECK(integral(2_df, 1_df, 1e-12_df, negativeSq) == Approx(2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating square function on negative x-axis side")
     {
-        CHECK(integral(-2_df, -1_df, 100_df, &sq) == Approx(2.33_df).margin(0.01_df));
+        CHECK(integral(-2_df, -1_df, 1e-12_df, &sq) == Approx(2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating square function on negative x-axis side in opposite direction")
     {
-        CHECK(integral(-1_df, -2_df, 100_df, &sq) == Approx(-2.33_df).margin(0.01_df));
+        CHECK(integral(-1_df, -2_df, 1e-12_df, &sq) == Approx(-2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating negated square function on negative x-axis side")
@@ -57,7 +57,7 @@ TEST_CASE("Integral", "[math]") // NOLINT
         auto negativeSq = [](Decimal x) {
             return -x * x;
         };
-        CHECK(integral(-2_df, -1_df, 100_df, negativeSq) == Approx(-2.33_df).margin(0.01_df));
+        CHECK(integral(-2_df, -1_df, 1e-12_df, negativeSq) == Approx(-2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating negated square function on negative x-axis side in opposite direction")
@@ -65,12 +65,25 @@ TEST_CASE("Integral", "[math]") // NOLINT
         auto negativeSq = [](Decimal x) {
             return -x * x;
         };
-        CHECK(integral(-1_df, -2_df, 100_df, negativeSq) == Approx(2.33_df).margin(0.01_df));
+        CHECK(integral(-1_df, -2_df, 1e-12_df, negativeSq) == Approx(2.33_df).margin(0.01_df));
     }
 
     SECTION("integrating sinus results in 0 due to self-elimination")
     {
-        CHECK(integral(0_pi, 2_pi, 10000_df, &Radian<Decimal>::sin) == Approx(0).margin(0.00001));
+        CHECK(integral(0_pi, 2_pi, 1e-12_df, &Radian<Decimal>::sin) == Approx(0).margin(0.00001));
+    }
+
+    SECTION("polynomials are integrated exactly")
+    {
+        CHECK(integral(1_df, 2_df, 1e-12_df, &sq) == Approx(7 / 3_df).epsilon(1e-14));
+    }
+
+    SECTION("adaptive subdivision reaches the tolerance on steep slopes")
+    {
+        auto root = [](Decimal x) {
+            return std::sqrt(x);
+        };
+        CHECK(integral(0_df, 1_df, 1e-10_df, root) == Approx(2 / 3_df).margin(1e-10));
     }
 
 }
@@ -0,0 +1,96 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include "common.h"
+#include <orbital/math/kepler.h>
+
+TEST_CASE("Kepler drift", "[math]") // NOLINT
+{
+
+    Decimal const mu = G() * 1.9884e30;
+    Decimal const r = au(1);
+
+    SECTION("stumpff functions are continuous where series and closed form meet")
+    {
+        for (Decimal const z : {1e-3, -1e-3})
+        {
+            CHECK(stumpffC(z * (1 - 1e-9)) == Approx(stumpffC(z * (1 + 1e-9))).epsilon(1e-12));
+            CHECK(stumpffS(z * (1 - 1e-9)) == Approx(stumpffS(z * (1 + 1e-9))).epsilon(1e-12));
+        }
+        CHECK(stumpffC(0.0) == Approx(0.5));
+        CHECK(stumpffS(0.0) == Approx(1.0 / 6));
+    }
+
+    SECTION("circular orbit advances by a quarter turn in a quarter period")
+    {
+        Decimal const v = std::sqrt(mu / r);
+        Decimal const period = 2 * boost::math::constants::pi<Decimal>() * r / v;
+
+        auto const drifted = keplerDrift(mu, vec{r, 0}, vec{0, v}, period / 4);
+        CHECK(drifted.position.x == Approx(0).margin(r * 1e-9));
+        CHECK(drifted.position.y == Approx(r));
+        CHECK(drifted.velocity.x == Approx(-v));
+        CHECK(drifted.velocity.y == Approx(0).margin(v * 1e-9));
+        CHECK(drifted.iterations <= 3);
+    }
+
+    SECTION("eccentric orbit returns to its start after steps adding up to a period")
+    {
+        Decimal const e = 0.6;
+        Decimal const a = r;
+        vec const r0{a * (1 - e), 0};
+        vec const v0{0, std::sqrt(mu * (1 + e) / (a * (1 - e)))};
+        Decimal const period = 2 * boost::math::constants::pi<Decimal>() * std::sqrt(a * a * a / mu);
+
+        vec position = r0;
+        vec velocity = v0;
+        for (int i = 0; i < 7; i++)
+        {
+            auto const drifted = keplerDrift(mu, position, velocity, period / 7);
+            position = drifted.position;
+            velocity = drifted.velocity;
+        }
+        CHECK(position.x == Approx(r0.x));
+        CHECK(position.y == Approx(0).margin(r * 1e-9));
+        CHECK(velocity.x == Approx(0).margin(v0.y * 1e-9));
+        CHECK(velocity.y == Approx(v0.y));
+    }
+
+    SECTION("hyperbolic orbit keeps energy and angular momentum, backwards too")
+    {
+        vec const r0{r, 0};
+        vec const v0{1e3, 2 * std::sqrt(mu / r)};
+        auto energy = [&](vec const &p, vec const &v) {
+            return (v.x * v.x + v.y * v.y) / 2 - mu / std::sqrt(p.x * p.x + p.y * p.y);
+        };
+        auto momentum = [](vec const &p, vec const &v) {
+            return p.x * v.y - p.y * v.x;
+        };
+        REQUIRE(energy(r0, v0) > 0);
+
+        auto const forward = keplerDrift(mu, r0, v0, 1e8);
+        CHECK(energy(forward.position, forward.velocity) == Approx(energy(r0, v0)));
+        CHECK(momentum(forward.position, forward.velocity) == Approx(momentum(r0, v0)));
+
+        auto const backward = keplerDrift(mu, forward.position, forward.velocity, -1e8);
+        CHECK(backward.position.x == Approx(r0.x));
+        CHECK(backward.position.y == Approx(0).margin(r * 1e-9));
+    }
+
+    SECTION("nearly radial hyperbolic orbit passing periapsis converges")
+    {
+        // Flyby of a massive planet, whose first steps overshoot far beyond periapsis:
+        Decimal const planet = 3.25e17;
+        vec const r0{573815692.07261658, 225034509.45168877};
+        vec const v0{-124994.08801514046, -49034.848219551379};
+        auto const drifted = keplerDrift(planet, r0, v0, 5035.3928863182664);
+        CHECK(drifted.iterations < 20);
+
+        auto const back = keplerDrift(planet, drifted.position, drifted.velocity, -5035.3928863182664);
+        CHECK(back.position.x == Approx(r0.x).epsilon(1e-6));
+        CHECK(back.position.y == Approx(r0.y).epsilon(1e-6));
+    }
+
+}
@@ -0,0 +1,174 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <orbital/math/elementary.h>
+#include <orbital/math/kepler.h>
+#include <orbital/math/lambert.h>
+#include <orbital/physical/Porkchop.h>
+#include <orbital/physical/System.h>
+
+TEST_CASE("Lambert's problem", "[math]") // NOLINT
+{
+    Decimal const mu = 1.327e20;
+    Decimal const day = 86400;
+
+    SECTION("transfers arrive at the target in time")
+    {
+        // Flying the arrival state back does not amplify the error in the departure velocity, unlike flying forward.
+        // Precision is bounded by that of keplerDrift():
+        std::mt19937_64 random{42};
+        std::uniform_real_distribution<Decimal> angle{0, 6.283};
+        std::uniform_real_distribution<Decimal> radius{au(0.3), au(3)};
+        std::uniform_real_distribution<Decimal> time{5 * day, 1500 * day};
+        for (int i = 0; i < 1000; i++)
+        {
+            auto const a1 = angle(random);
+            auto const a2 = angle(random);
+            auto const r1 = radius(random);
+            auto const r2 = radius(random);
+            vec const p1{r1 * std::cos(a1), r1 * std::sin(a1)};
+            vec const p2{r2 * std::cos(a2), r2 * std::sin(a2)};
+            auto const tof = time(random);
+            auto const transfer = lambert(mu, p1, p2, tof);
+            auto const back = keplerDrift(mu, p2, transfer.arrival, -tof);
+            CHECK(length(back.position - p1) < 1e-6 * r1);
+            CHECK(length(back.velocity - transfer.departure) < 1e-6 * length(transfer.departure));
+        }
+    }
+
+    SECTION("transfers between nearly the same directions arrive in time")
+    {
+        // Lambda approaches 1, where the time of flight bends sharply and Householder's method overshoots, e.g. at
+        // 1e-3 rad and 895 days:
+        Decimal const r = au(1);
+        vec const p1{r, 0};
+        for (Decimal const angle : {1e-3, 1e-2, 6.282})
+        {
+            vec const p2{r * std::cos(angle), r * std::sin(angle)};
+            for (Decimal tof = 5 * day; tof < 1500 * day; tof += 10 * day)
+            {
+                auto const transfer = lambert(mu, p1, p2, tof);
+                auto const back = keplerDrift(mu, p2, transfer.arrival, -tof);
+                CHECK(length(back.position - p1) < 1e-6 * r);
+            }
+        }
+    }
+
+    SECTION("Hohmann transfer")
+    {
+        // Half a turn is ambiguous in direction, so go slightly less:
+        Decimal const r1 = au(1);
+        Decimal const r2 = au(1.524);
+        Decimal const a = (r1 + r2) / 2;
+        Decimal const tof = boost::math::constants::pi<Decimal>() * std::sqrt(a * a * a / mu);
+        auto const transfer = lambert(mu, vec{r1, 0}, vec{-r2, 1e-6 * r2}, tof);
+        CHECK(transfer.departure.x == Approx(0).margin(1));
+        CHECK(transfer.departure.y == Approx(std::sqrt(mu * (2 / r1 - 1 / a))).epsilon(1e-5));
+        CHECK(transfer.arrival.y == Approx(-std::sqrt(mu * (2 / r2 - 1 / a))).epsilon(1e-5));
+    }
+
+    SECTION("batch equals scalar")
+    {
+        std::vector<vec> r1;
+        std::vector<vec> r2;
+        std::vector<Decimal> tof;
+        for (int i = 0; i < 100; i++)
+        {
+            r1.push_back({au(1), 0});
+            r2.push_back({au(1.5) * std::cos(0.06 * i), au(1.5) * std::sin(0.06 * i)});
+            tof.push_back((i - 10) * 10 * day);
+        }
+        std::vector<vec> v1(r1.size());
+        std::vector<vec> v2(r1.size());
+        lambertBatch<Decimal>(mu, r1, r2, tof, v1, v2);
+        for (std::size_t i = 0; i < r1.size(); i++)
+        {
+            if (tof[i] <= 0)
+            {
+                CHECK(std::isnan(v1[i].x));
+                continue;
+            }
+            auto const transfer = lambert(mu, r1[i], r2[i], tof[i]);
+            CHECK(v1[i].x == transfer.departure.x);
+            CHECK(v1[i].y == transfer.departure.y);
+            CHECK(v2[i].x == transfer.arrival.x);
+            CHECK(v2[i].y == transfer.arrival.y);
+        }
+    }
+}
+
+TEST_CASE("Porkchop", "[physical]") // NOLINT
+{
+    Decimal const sunMass = 1.9884e30;
+    Decimal const mu = G() * sunMass;
+    Decimal const day = 86400;
+    System system{Body{"Sun", sunMass, 7e8, 0, 0}, day};
+    system.add(Body{"Earth", 5.97e24, 6.4e6, au(1), 1e-3});
+    system.add(Body{"Mars", 6.42e23, 3.4e6, au(1.524), 1e-3});
+    Porkchop porkchop{system, "Earth", "Mars"};
+
+    // Two synodic periods of departures, and arrivals over them and the longest transfers:
+    PorkchopGrid const grid{0, 10 * day, 160, 40 * day, 5 * day, 400};
+
+    std::stringstream file;
+    porkchop.write(grid, file, 4);
+
+    std::uint32_t departures = 0;
+    std::uint32_t arrivals = 0;
+    double header[4]{};
+    file.read(reinterpret_cast<char *>(&departures), sizeof(departures));
+    file.read(reinterpret_cast<char *>(&arrivals), sizeof(arrivals));
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    CHECK(departures == grid.departures);
+    CHECK(arrivals == grid.arrivals);
+    CHECK(header[0] == grid.departureBegin);
+    CHECK(header[1] == grid.departureStep);
+    CHECK(header[2] == grid.arrivalBegin);
+    CHECK(header[3] == grid.arrivalStep);
+    std::vector<float> deltaV(departures * arrivals);
+    file.read(reinterpret_cast<char *>(deltaV.data()), deltaV.size() * sizeof(float));
+    CHECK(file.gcount() == deltaV.size() * sizeof(float));
+
+    SECTION("rows equal those streamed")
+    {
+        std::vector<float> row(arrivals);
+        for (std::uint32_t i : {0u, 63u, 64u, 159u})
+        {
+            porkchop.row(grid, i, row);
+            for (std::uint32_t j = 0; j < arrivals; j++)
+            {
+                auto const streamed = deltaV[i * arrivals + j];
+                CHECK((std::isnan(row[j]) ? std::isnan(streamed) : row[j] == streamed));
+            }
+        }
+    }
+
+    SECTION("transfers back in time are invalid")
+    {
+        CHECK(std::isnan(deltaV[100 * arrivals]));
+        CHECK(!std::isnan(deltaV[100 * arrivals + arrivals - 1]));
+    }
+
+    SECTION("best transfer is close to Hohmann's")
+    {
+        Decimal const r1 = au(1);
+        Decimal const r2 = au(1.524);
+        Decimal const a = (r1 + r2) / 2;
+        Decimal const hohmann = std::sqrt(mu * (2 / r1 - 1 / a)) - std::sqrt(mu / r1)
+                                + std::sqrt(mu / r2) - std::sqrt(mu * (2 / r2 - 1 / a));
+        float best = INFINITY;
+        for (auto const value : deltaV)
+        {
+            best = std::isnan(value) ? best : std::min(best, value);
+        }
+        // Orbits are nearly circular, for which Hohmann's transfer is the best one:
+        CHECK(best > hohmann * 0.99);
+        CHECK(best < hohmann * 1.05);
+    }
+}
@@ -2,8 +2,13 @@
 // Created by jim on 29.01.18.
 //
 
+#include <algorithm>
+#include <limits>
+#include <vector>
 #include <orbital/common/common.h>
+#include <orbital/math/CompensatedSum.h>
 #include <orbital/math/elementary.h>
+#include <orbital/math/hilbert.h>
 
 #include "catch/catch.hpp"
 #include "common.h"
@@ -73,6 +78,57 @@ TEST_CASE("Radians", "[math]")
         CHECK(radian.tan() == Approx{0}.margin(0.000001));
     }
 
+    SECTION("fused sine and cosine")
+    {
+        for (Decimal x = -100; x < 100; x += 0.01)
+        {
+            auto const [sin, cos] = Radian{x}.sincos();
+            CHECK(sin == std::sin(x));
+            CHECK(cos == std::cos(x));
+        }
+    }
+
+    SECTION("fast sine and cosine")
+    {
+        Decimal maxError = 0;
+        for (Decimal x = -100; x < 100; x += 0.001)
+        {
+            auto const [sin, cos] = Radian{x}.sincos<FastTrig>();
+            maxError = std::max({maxError, std::abs(sin - std::sin(x)), std::abs(cos - std::cos(x))});
+        }
+        for (Decimal x : {1e3, -1e5, 1e6, (0.25_pi).getRaw(), (0.75_pi).getRaw(), (-1.25_pi).getRaw()})
+        {
+            auto const [sin, cos] = Radian{x}.sincos<FastTrig>();
+            maxError = std::max({maxError, std::abs(sin - std::sin(x)), std::abs(cos - std::cos(x))});
+        }
+        CHECK(maxError < FastTrig::maxError());
+    }
+
+    SECTION("fast sine and cosine keep their quadrant beyond the range of int")
+    {
+        for (Decimal x : {5e9, -5e9, 1e12})
+        {
+            auto const [sin, cos] = FastTrig::sincos(x);
+            CHECK(std::abs(sin - std::sin(x)) < 1e-5);
+            CHECK(std::abs(cos - std::cos(x)) < 1e-5);
+        }
+        auto const [sin, cos] = FastTrig::sincos(std::numeric_limits<Decimal>::infinity());
+        CHECK(std::isnan(sin));
+        CHECK(std::isnan(cos));
+    }
+
+    SECTION("fast sine and cosine in single precision")
+    {
+        // Bound by single precision rounding, of the result and of the reduced angle:
+        double maxError = 0;
+        for (float x = -1000; x < 1000; x += 0.01f)
+        {
+            auto const [sin, cos] = FastTrig::sincos(x);
+            maxError = std::max({maxError, std::abs(sin - std::sin(double{x})), std::abs(cos - std::cos(double{x}))});
+        }
+        CHECK(maxError < 1e-6);
+    }
+
     SECTION("inverse trigonometric functions")
     {
         CHECK(Radian<Decimal>::arcsin(1) == approx(0.5_pi).margin(0.000001));
@@ -81,3 +137,79 @@ TEST_CASE("Radians", "[math]")
         CHECK(Radian<Decimal>::arctan2(2, 3) == Approx{std::atan2(2, 3)}.margin(0.000001));
     }
 }
+
+TEST_CASE("Compensated sum", "[math]") // NOLINT
+{
+
+    SECTION("small values are not lost next to large ones")
+    {
+        CompensatedSum<Decimal> sum;
+        Decimal naive = 0;
+        for (Decimal const value : {1.0, 1e100, 1.0, -1e100})
+        {
+            sum += value;
+            naive += value;
+        }
+        CHECK(naive == 0);
+        CHECK(sum.value() == 2);
+    }
+
+    SECTION("many small increments")
+    {
+        CompensatedSum<Decimal> sum;
+        Decimal naive = 0;
+        for (int i = 0; i < 1000000; i++)
+        {
+            sum += 0.1;
+            naive += 0.1;
+        }
+        CHECK(std::abs(sum.value() - 100000) < std::abs(naive - 100000) / 100);
+    }
+
+    SECTION("partial sums")
+    {
+        CompensatedSum<Decimal> first;
+        CompensatedSum<Decimal> second;
+        first += 1e100;
+        first += 1;
+        second += -1e100;
+        second += 1;
+        first += second;
+        CHECK(first.value() == 2);
+    }
+}
+
+TEST_CASE("Hilbert curve", "[math]") // NOLINT
+{
+
+    SECTION("quadrants are visited in order")
+    {
+        std::uint32_t const half = 1u << 31u;
+        CHECK(hilbertIndex(0, 0) == 0);
+        CHECK(hilbertIndex(0, half) < hilbertIndex(half, half));
+        CHECK(hilbertIndex(half, half) < hilbertIndex(half, 0));
+        CHECK(hilbertIndex(~0u, 0) == ~std::uint64_t{0});
+    }
+
+    SECTION("consecutive cells are adjacent")
+    {
+        // Cells of a coarse grid, each in the lowest corner of a block of the full grid:
+        std::uint32_t const cells = 16;
+        std::uint32_t const shift = 28;
+        std::vector<std::pair<std::uint64_t, std::pair<int, int>>> curve;
+        for (std::uint32_t x = 0; x < cells; x++)
+        {
+            for (std::uint32_t y = 0; y < cells; y++)
+            {
+                curve.push_back({hilbertIndex(x << shift, y << shift), {x, y}});
+            }
+        }
+        std::sort(curve.begin(), curve.end());
+        for (std::size_t i = 1; i < curve.size(); i++)
+        {
+            auto const [x0, y0] = curve[i - 1].second;
+            auto const [x1, y1] = curve[i].second;
+            CHECK(std::abs(x1 - x0) + std::abs(y1 - y0) == 1);
+        }
+    }
+}
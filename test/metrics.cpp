@@ -0,0 +1,57 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/common/Metrics.h>
+#include <thread>
+
+TEST_CASE("Metrics", "[common]") // NOLINT
+{
+    Metrics metrics;
+    Counter &steps = metrics.counter("steps");
+    Counter &pixels = metrics.counter("pixels");
+
+    SECTION("counters are registered once")
+    {
+        CHECK(&metrics.counter("steps") == &steps);
+        CHECK(metrics.read().size() == 2);
+    }
+
+    SECTION("values are read by name and in registration order")
+    {
+        steps.add();
+        pixels.add(5);
+
+        CHECK(metrics.value("steps") == 1);
+        CHECK(metrics.value("pixels") == 5);
+        CHECK_THROWS(metrics.value("bytes"));
+        CHECK(metrics.format() == "steps=1 pixels=5");
+
+        metrics.reset();
+        CHECK(metrics.format() == "steps=0 pixels=0");
+    }
+
+    SECTION("concurrent increments are aggregated")
+    {
+        constexpr std::size_t threads = 2 * Counter::shards() + 1;
+        constexpr std::size_t increments = 10000;
+
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            workers.emplace_back([&] {
+                for (std::size_t j = 0; j < increments; j++)
+                {
+                    steps.add();
+                }
+            });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        CHECK(steps.value() == threads * increments);
+    }
+}
@@ -0,0 +1,356 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include "common.h"
+#include <orbital/math/kepler.h>
+#include <orbital/physical/NBody.h>
+#include <orbital/physical/System.h>
+
+namespace
+{
+
+Decimal const sunMass = 1.9884e30;
+
+/**
+ * Largest relative error of the two-body energy over one year, with the Earth on an eccentric orbit.
+ * @param integrator Integrator.
+ * @param dt [s] Time step.
+ * @return Relative energy error.
+ */
+Decimal
+energyError(
+        Integrator const integrator,
+        Decimal const dt
+)
+{
+    Decimal const m = 5.97e24;
+    Decimal const mu = G() * (sunMass + m);
+    Decimal const e = 0.3;
+    vec const r0{au(1 - e), 0};
+    vec const v0{0, std::sqrt(mu * (1 + e) / au(1 - e))};
+
+    auto energy = [&](vec const &p, vec const &v) {
+        return (v.x * v.x + v.y * v.y) / 2 - mu / std::sqrt(p.x * p.x + p.y * p.y);
+    };
+
+    NBody nbody{sunMass, std::vector<Decimal>{m}, std::vector<vec>{r0}, std::vector<vec>{v0}};
+    Decimal const initial = energy(r0, v0);
+    Decimal error = 0;
+    for (Decimal t = 0; t < 365.25 * 86400; t += dt)
+    {
+        nbody.step(integrator, dt, 1);
+        error = std::max(error, std::abs(energy(nbody.position(1), nbody.velocity(1)) / initial - 1));
+    }
+    return error;
+}
+
+}
+
+TEST_CASE("N-body", "[physical]") // NOLINT
+{
+
+    SECTION("integrators by name")
+    {
+        CHECK(integratorFromName("projection") == Integrator::Projection);
+        CHECK(integratorFromName("yoshida6") == Integrator::Yoshida6);
+        CHECK(integratorFromName("wisdom-holman") == Integrator::WisdomHolman);
+        CHECK(integratorFromName("dormand-prince5") == Integrator::DormandPrince5);
+        CHECK(integratorFromName("dormand-prince853") == Integrator::DormandPrince853);
+        CHECK_THROWS_AS(integratorFromName("euler"), std::runtime_error);
+    }
+
+    SECTION("higher orders keep energy better at the same step")
+    {
+        Decimal const dt = 2 * 86400;
+        auto const leapfrog = energyError(Integrator::Leapfrog, dt);
+        auto const yoshida4 = energyError(Integrator::Yoshida4, dt);
+        auto const yoshida6 = energyError(Integrator::Yoshida6, dt);
+        CHECK(leapfrog < 1e-3);
+        CHECK(yoshida4 < leapfrog / 100);
+        CHECK(yoshida6 < yoshida4 / 10);
+    }
+
+    SECTION("Wisdom-Holman is nearly exact for a single light planet, even at large steps")
+    {
+        Decimal const m = 1e10;
+        Decimal const mu = G() * sunMass;
+        vec const r0{au(0.7), 0};
+        vec const v0{0, std::sqrt(mu * 1.3 / au(0.7))};
+        Decimal const dt = 30 * 86400;
+
+        NBody nbody{sunMass, std::vector<Decimal>{m}, std::vector<vec>{r0}, std::vector<vec>{v0}};
+        std::size_t iterations = 0;
+        for (int i = 0; i < 24; i++)
+        {
+            iterations += nbody.step(Integrator::WisdomHolman, dt, 1);
+        }
+        auto const exact = keplerDrift(mu, r0, v0, 24 * dt);
+        CHECK(nbody.position(1).x == Approx(exact.position.x).margin(au(1e-9)));
+        CHECK(nbody.position(1).y == Approx(exact.position.y).margin(au(1e-9)));
+        CHECK(iterations > 0);
+        CHECK(energyError(Integrator::WisdomHolman, 30 * 86400) < energyError(Integrator::Yoshida4, 2 * 86400));
+    }
+
+    SECTION("adaptive integrators follow a comet through perihelion")
+    {
+        // Halley's comet, starting at aphelion:
+        Decimal const m = 2.2e14;
+        Decimal const mu = G() * (sunMass + m);
+        Decimal const a = au(17.834);
+        Decimal const e = 0.967;
+        vec const r0{-a * (1 + e), 0};
+        vec const v0{0, -std::sqrt(mu * (1 - e) / (a * (1 + e)))};
+        Decimal const period = 2 * boost::math::constants::pi<Decimal>() * std::sqrt(a * a * a / mu);
+        Decimal const dt = period / 50;
+
+        std::size_t substeps[2]{};
+        for (auto const integrator : {Integrator::DormandPrince5, Integrator::DormandPrince853})
+        {
+            NBody nbody{sunMass, std::vector<Decimal>{m}, std::vector<vec>{r0}, std::vector<vec>{v0}};
+            std::size_t total = 0;
+            std::size_t most = 0;
+            for (int i = 0; i < 50; i++)
+            {
+                nbody.step(integrator, dt, 1);
+                total += nbody.substeps();
+                most = std::max(most, nbody.substeps());
+            }
+            substeps[Integrator::DormandPrince853 == integrator] = total;
+
+            // Back at aphelion, with the error of each substep bound by the tolerance:
+            CHECK(nbody.position(1).x == Approx(r0.x).epsilon(1e-6));
+            CHECK(nbody.position(1).y == Approx(0).margin(a * 1e-5));
+
+            // Substeps cluster around perihelion:
+            CHECK(most > 5 * total / 50);
+        }
+        CHECK(substeps[1] < substeps[0]);
+    }
+
+    SECTION("adaptive integrators reject steps with NaN errors")
+    {
+        // Errors stay NaN however small the step, so retries stop after the maximum count of rejections:
+        for (auto const integrator : {Integrator::DormandPrince5, Integrator::DormandPrince853})
+        {
+            NBody nbody{sunMass, std::vector<Decimal>{5.97e24}, std::vector<vec>{{au(1), 0}},
+                        std::vector<vec>{{NAN, 3e4}}};
+            CHECK_THROWS_AS(nbody.step(integrator, 86400, 1), std::runtime_error);
+            CHECK(nbody.substeps() == NBody::maximumRejections() + 1);
+            CHECK(nbody.time() == 0);
+        }
+    }
+
+    SECTION("a failing step leaves the time unchanged")
+    {
+        for (auto const integrator : {Integrator::DormandPrince5, Integrator::DormandPrince853})
+        {
+            NBody nbody{sunMass, std::vector<Decimal>{5.97e24}, std::vector<vec>{{au(1), 0}},
+                        std::vector<vec>{{0, 3e4}}};
+            nbody.step(integrator, 86400, 1);
+            CHECK(nbody.time() == 86400);
+
+            // No error is small enough, so substeps are rejected until giving up:
+            nbody.tolerance(0);
+            CHECK_THROWS_AS(nbody.step(integrator, 86400, 1), std::runtime_error);
+            CHECK(nbody.time() == 86400);
+        }
+    }
+
+    SECTION("dense output interpolates within the last substep")
+    {
+        Decimal const m = 1e10;
+        Decimal const mu = G() * (sunMass + m);
+        vec const r0{au(0.5), 0};
+        vec const v0{0, std::sqrt(mu * 1.5 / au(0.5))};
+        Decimal const dt = 86400;
+
+        NBody nbody{sunMass, std::vector<Decimal>{m}, std::vector<vec>{r0}, std::vector<vec>{v0}};
+        nbody.tolerance(1e-8);
+        nbody.step(Integrator::DormandPrince5, dt, 1);
+        REQUIRE(nbody.substeps() == 1);
+        CHECK(nbody.interpolatedPosition(1, dt).x == Approx(nbody.position(1).x));
+        CHECK(nbody.interpolatedPosition(1, dt).y == Approx(nbody.position(1).y));
+
+        // The 4th order interpolation is about as accurate as the 5th order solution at the end of the substep:
+        for (Decimal const fraction : {0.25, 0.5, 0.75})
+        {
+            auto const exact = keplerDrift(mu, r0, v0, fraction * dt);
+            auto const interpolated = nbody.interpolatedPosition(1, fraction * dt);
+            CHECK(interpolated.x == Approx(exact.position.x).margin(100));
+            CHECK(interpolated.y == Approx(exact.position.y).margin(100));
+        }
+    }
+
+    SECTION("dense output converges at the order of the interpolant")
+    {
+        Decimal const m = 1e10;
+        Decimal const mu = G() * (sunMass + m);
+        vec const r0{au(0.5), 0};
+        vec const v0{0, std::sqrt(mu * 1.5 / au(0.5))};
+
+        // Interpolation error in the middle of a single substep of the given size:
+        auto error = [&](
+                Integrator const integrator,
+                Decimal const dt
+        ) {
+            NBody nbody{sunMass, std::vector<Decimal>{m}, std::vector<vec>{r0}, std::vector<vec>{v0}};
+            nbody.tolerance(1);
+            nbody.step(integrator, dt, 1);
+            REQUIRE(nbody.substeps() == 1);
+            auto const exact = keplerDrift(mu, r0, v0, dt / 2);
+            auto const interpolated = nbody.interpolatedPosition(1, dt / 2);
+            return std::hypot(interpolated.x - exact.position.x, interpolated.y - exact.position.y);
+        };
+
+        // Halving the substep divides the error of a p-th order interpolant by about 2^(p + 1):
+        std::pair<Integrator, int> const orders[]{{Integrator::DormandPrince5, 4}, {Integrator::DormandPrince853, 7}};
+        for (auto const &[integrator, order] : orders)
+        {
+            Decimal const ratio = error(integrator, 4 * 86400) / error(integrator, 2 * 86400);
+            CHECK(ratio > 0.75 * std::pow(2, order + 1));
+        }
+    }
+
+    SECTION("angular momentum is conserved")
+    {
+        std::vector<Decimal> const masses{1.9e27, 5.7e26, 6.4e23};
+        std::vector<vec> const positions{{au(5.2), 0}, {0, au(9.5)}, {au(-1.5), 0}};
+        std::vector<vec> const velocities{{0, 13e3}, {-9.7e3, 0}, {0, -24e3}};
+
+        // Total angular momentum around the barycenter, from the states relative to the central body:
+        auto angularMomentum = [&](NBody const &nbody) {
+            Decimal total = sunMass;
+            vec moment{};
+            vec momentum{};
+            for (std::size_t i = 1; i < nbody.size(); i++)
+            {
+                total += masses[i - 1];
+                moment += nbody.position(i) * masses[i - 1];
+                momentum += nbody.velocity(i) * masses[i - 1];
+            }
+            Decimal result = 0;
+            for (std::size_t i = 0; i < nbody.size(); i++)
+            {
+                Decimal const m = 0 == i ? sunMass : masses[i - 1];
+                vec const x = nbody.position(i) - moment / total;
+                vec const v = nbody.velocity(i) - momentum / total;
+                result += m * (x.x * v.y - x.y * v.x);
+            }
+            return result;
+        };
+
+        NBody nbody{sunMass, masses, positions, velocities};
+        auto const initial = angularMomentum(nbody);
+        for (int i = 0; i < 100; i++)
+        {
+            nbody.step(Integrator::Yoshida4, 10 * 86400, 2);
+        }
+        CHECK(angularMomentum(nbody) == Approx(initial).epsilon(1e-10));
+    }
+
+    SECTION("invariants measured while stepping match a separate measurement")
+    {
+        std::vector<Decimal> const masses{1.9e27, 5.7e26, 6.4e23};
+        std::vector<vec> const positions{{au(5.2), 0}, {0, au(9.5)}, {au(-1.5), 0}};
+        std::vector<vec> const velocities{{0, 13e3}, {-9.7e3, 0}, {0, -24e3}};
+
+        for (auto const integrator : {Integrator::Leapfrog, Integrator::Yoshida6, Integrator::WisdomHolman,
+                                      Integrator::DormandPrince5, Integrator::DormandPrince853})
+        {
+            NBody nbody{sunMass, masses, positions, velocities};
+            nbody.diagnose(true);
+            auto const initial = nbody.invariants();
+            for (int i = 0; i < 20; i++)
+            {
+                nbody.step(integrator, 10 * 86400, 2);
+            }
+            auto const measured = nbody.measure();
+            CHECK(nbody.invariants().energy == Approx(measured.energy).epsilon(1e-12));
+            CHECK(nbody.invariants().angularMomentum == Approx(measured.angularMomentum).epsilon(1e-12));
+            CHECK(nbody.drift().energy == Approx((measured.energy - initial.energy) / -initial.energy).margin(1e-14));
+            CHECK(std::abs(nbody.drift().energy) < 1e-5);
+        }
+    }
+
+    SECTION("energy drift grows with the time step")
+    {
+        auto drift = [](Decimal const dt) {
+            NBody nbody{sunMass, std::vector<Decimal>{3.3e23}, std::vector<vec>{{au(0.3075), 0}},
+                    std::vector<vec>{{0, 58975}}};
+            nbody.diagnose(true);
+            Decimal largest = 0;
+            for (Decimal t = 0; t < 88 * 86400; t += dt)
+            {
+                nbody.step(Integrator::Leapfrog, dt, 1);
+                largest = std::max(largest, std::abs(nbody.drift().energy));
+            }
+            return largest;
+        };
+        CHECK(drift(86400) > 3 * drift(86400 / 2));
+    }
+
+    SECTION("reordering keeps body indices")
+    {
+        // Asteroids on a ring, added in scattered order by stepping the angle by the golden angle:
+        std::vector<Decimal> masses;
+        std::vector<vec> positions;
+        std::vector<vec> velocities;
+        for (int i = 0; i < 256; i++)
+        {
+            Decimal const r = au(2.2 + 0.001 * i);
+            Decimal const v = std::sqrt(G() * sunMass / r);
+            Decimal const angle = 2.39996 * i;
+            masses.push_back(1e18);
+            positions.emplace_back(r * std::cos(angle), r * std::sin(angle));
+            velocities.emplace_back(-v * std::sin(angle), v * std::cos(angle));
+        }
+        NBody nbody{sunMass, masses, positions, velocities};
+        nbody.step(Integrator::DormandPrince5, 86400, 2);
+        NBody reordered = nbody;
+        CHECK(reordered.reorder());
+        CHECK(reordered.locality() < nbody.locality() / 10);
+
+        // State moves along unchanged, and stepping continues alike up to the order of summation:
+        for (std::size_t i = 0; i < nbody.size(); i++)
+        {
+            CHECK(reordered.position(i) == nbody.position(i));
+            CHECK(reordered.velocity(i) == nbody.velocity(i));
+            CHECK(reordered.interpolatedPosition(i, 43200) == nbody.interpolatedPosition(i, 43200));
+        }
+        nbody.step(Integrator::DormandPrince5, 86400, 2);
+        reordered.step(Integrator::DormandPrince5, 86400, 2);
+        for (std::size_t i = 0; i < nbody.size(); i++)
+        {
+            CHECK(reordered.position(i).x == Approx(nbody.position(i).x).margin(1e-3));
+            CHECK(reordered.position(i).y == Approx(nbody.position(i).y).margin(1e-3));
+        }
+    }
+
+    SECTION("system selects its integrator")
+    {
+        System system{Body{"Sun", sunMass, 7e8, 0, 0}, 86400};
+        system.add(Body{"Earth", 5.97e24, 6.4e6, au(1), 0.0167});
+        system.diagnostics(true);
+        CHECK(system.integrator() == Integrator::Projection);
+        system.stepSimulation();
+        CHECK(!system.drift());
+
+        system.integrator(Integrator::WisdomHolman);
+        for (int i = 0; i < 365; i++)
+        {
+            system.stepSimulation();
+        }
+        CHECK(system.metrics().counter("kepler-iterations").value() > 0);
+        // A single planet has no storage order to renew:
+        CHECK(system.metrics().counter("reorders").value() == 0);
+        REQUIRE(system.drift());
+        CHECK(std::abs(system.drift()->energy) < 1e-6);
+
+        // Earth still orbits at about 1 AU, after a year it's close to where it started:
+        auto const position = system.find("Earth").getPosition();
+        CHECK(glm::length(position) == Approx(au(0.983)).epsilon(0.02));
+    }
+
+}
@@ -0,0 +1,102 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/math/elementary.h>
+#include <orbital/math/kepler.h>
+#include <orbital/physical/PatchedConics.h>
+#include <orbital/physical/System.h>
+
+TEST_CASE("Patched conics", "[physical]") // NOLINT
+{
+    Decimal const sunMass = 1.9884e30;
+    Decimal const mu = G() * sunMass;
+    Decimal const day = 86400;
+    System system{Body{"Sun", sunMass, 7e8, 0, 0}, day};
+    system.add(Body{"Earth", 5.97e24, 6.4e6, au(1), 0.0167});
+    system.add(Body{"Mars", 6.42e23, 3.4e6, au(1.524), 0.0934});
+    auto const earth = system.find("Earth").orbitalState(sunMass);
+
+    // Earth moves on its Kepler orbit:
+    auto earthAt = [&](Decimal const time) {
+        return keplerDrift(mu, earth.position, earth.velocity, time);
+    };
+
+    PatchedConics conics{system};
+    CHECK(conics.sphereOfInfluence(1) == Approx(9.24e8).epsilon(0.01));
+
+    SECTION("spacecraft far from all bodies orbit the central body")
+    {
+        vec const r0{0, au(-3)};
+        vec const v0{std::sqrt(mu / au(3)) * 1.1, 0};
+        conics.add(r0, v0);
+        for (int i = 0; i < 10; i++)
+        {
+            conics.propagate(36.5 * day, 1);
+        }
+        auto const expected = keplerDrift(mu, r0, v0, 365 * day).position;
+        CHECK(conics.primary(0) == 0);
+        CHECK(conics.switches() == 0);
+        CHECK(conics.position(0).x == Approx(expected.x).margin(1));
+        CHECK(conics.position(0).y == Approx(expected.y).margin(1));
+    }
+
+    SECTION("spacecraft bound close to a body stay with it")
+    {
+        Decimal const r = 4.2e7;
+        conics.add(earth.position + vec{r, 0}, earth.velocity + vec{0, std::sqrt(G() * 5.97e24 / r)});
+        CHECK(conics.primary(0) == 1);
+        conics.propagate(365 * day, 1);
+        CHECK(conics.primary(0) == 1);
+        CHECK(conics.switches() == 0);
+        CHECK(length(conics.position(0) - earthAt(365 * day).position) == Approx(r).epsilon(1e-9));
+    }
+
+    SECTION("spacecraft fly by a body")
+    {
+        // Aim past Earth, as it will be in ten days, and go back along the heliocentric orbit for the start:
+        auto const target = earthAt(10 * day);
+        auto const start = keplerDrift(mu, target.position + vec{0, 2e7}, target.velocity + vec{3e3, 0}, -10 * day);
+
+        PatchedConics stepped{system};
+        conics.add(start.position, start.velocity);
+        stepped.add(start.position, start.velocity);
+        CHECK(conics.primary(0) == 0);
+
+        conics.propagate(10 * day, 1);
+        CHECK(conics.primary(0) == 1);
+        CHECK(conics.switches() == 1);
+        CHECK(length(conics.position(0) - target.position) < conics.sphereOfInfluence(1));
+
+        conics.propagate(50 * day, 1);
+        CHECK(conics.primary(0) == 0);
+        CHECK(conics.switches() == 2);
+
+        // Crossings are found independently of the time steps:
+        for (int i = 0; i < 60; i++)
+        {
+            stepped.propagate(day, 1);
+        }
+        CHECK(stepped.switches() == 2);
+        CHECK(length(stepped.position(0) - conics.position(0)) < 1e3);
+        CHECK(length(stepped.velocity(0) - conics.velocity(0)) < 1e-3);
+    }
+
+    SECTION("spacecraft are propagated in parallel")
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            Decimal const r = au(1.2 + 0.001 * i);
+            conics.add({r, 0}, {0, std::sqrt(mu / r) * 1.2});
+        }
+        PatchedConics serial = conics;
+        conics.propagate(2 * 365 * day, 4);
+        serial.propagate(2 * 365 * day, 1);
+        CHECK(conics.switches() == serial.switches());
+        for (std::size_t i = 0; i < conics.size(); i++)
+        {
+            CHECK(conics.position(i) == serial.position(i));
+        }
+    }
+}
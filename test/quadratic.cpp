@@ -0,0 +1,103 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include "common.h"
+#include <orbital/math/elementary.h>
+#include <random>
+
+TEST_CASE("Quadratic", "[math]") // NOLINT
+{
+
+    SECTION("two, one and no solutions")
+    {
+        auto two = quadratic<Decimal>(1, -3, 2);
+        REQUIRE(two.size() == 2);
+        CHECK(two[0] == 1);
+        CHECK(two[1] == 2);
+
+        auto one = quadratic<Decimal>(1, -2, 1);
+        REQUIRE(one.size() == 1);
+        CHECK(one[0] == 1);
+
+        CHECK(quadratic<Decimal>(1, 0, 1).empty());
+    }
+
+    SECTION("solutions are ascending, regardless of signs")
+    {
+        auto solutions = quadratic<Decimal>(-2, 2, 12);
+        REQUIRE(solutions.size() == 2);
+        CHECK(solutions[0] == -2);
+        CHECK(solutions[1] == 3);
+    }
+
+    SECTION("degenerated to linear")
+    {
+        auto solutions = quadratic<Decimal>(0, 2, -4);
+        REQUIRE(solutions.size() == 1);
+        CHECK(solutions[0] == 2);
+
+        CHECK(quadratic<Decimal>(0, 0, 1).empty());
+    }
+
+    SECTION("small root does not cancel out")
+    {
+        // Roots are 1e-9 and 1e9, the textbook formula gives 0 or a few digits for the small root:
+        auto solutions = quadratic<Decimal>(1, -(1e9 + 1e-9), 1);
+        REQUIRE(solutions.size() == 2);
+        CHECK(solutions[0] == Approx(1e-9).epsilon(1e-14));
+        CHECK(solutions[1] == Approx(1e9).epsilon(1e-14));
+    }
+
+    SECTION("nearly coinciding roots are one solution")
+    {
+        // (x - 0.1)², whose discriminant evaluates to about 7e-18 instead of 0:
+        auto solutions = quadratic<Decimal>(1, -0.2, 0.01);
+        REQUIRE(solutions.size() == 1);
+        CHECK(solutions[0] == Approx(0.1));
+    }
+
+    SECTION("batch equals scalar solver")
+    {
+        std::mt19937_64 random{3};
+        std::uniform_real_distribution<Decimal> coefficient{-10, 10};
+
+        constexpr std::size_t count = 1000;
+        std::vector<Decimal> a(count);
+        std::vector<Decimal> b(count);
+        std::vector<Decimal> c(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            a[i] = coefficient(random);
+            b[i] = coefficient(random);
+            c[i] = coefficient(random);
+        }
+        // Tangent:
+        a[0] = 1;
+        b[0] = -4;
+        c[0] = 4;
+
+        std::vector<Decimal> x0(count);
+        std::vector<Decimal> x1(count);
+        std::vector<std::uint8_t> counts(count);
+        quadraticBatch<Decimal>(a, b, c, x0, x1, counts);
+
+        CHECK(counts[0] == 1);
+        CHECK(x0[0] == 2);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            auto const solutions = quadratic(a[i], b[i], c[i]);
+            REQUIRE(solutions.size() == counts[i]);
+            if (counts[i] > 0)
+            {
+                CHECK(x0[i] == solutions[0]);
+            }
+            if (counts[i] > 1)
+            {
+                CHECK(x1[i] == solutions[1]);
+            }
+        }
+    }
+
+}
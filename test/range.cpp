@@ -0,0 +1,146 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/common/parallel.h>
+#include <orbital/common/range_parallel.h>
+#include <atomic>
+#include <numeric>
+
+TEST_CASE("Range", "[common]") // NOLINT
+{
+
+    SECTION("range visits every index in order")
+    {
+        std::vector<int> visited;
+        range(2, 6, [&](int const i) {
+            visited.push_back(i);
+        });
+        CHECK(visited == std::vector<int>{2, 3, 4, 5});
+    }
+
+    SECTION("reduce_range handles ranges too large for recursion")
+    {
+        auto const sum = reduce_range(std::uint64_t{0}, std::uint64_t{10000000}, std::uint64_t{0}, [](
+                std::uint64_t const sum,
+                std::uint64_t const i
+        ) {
+            return sum + i;
+        });
+        CHECK(sum == 49999995000000);
+    }
+
+    SECTION("reduce_range of an empty range gives the initial value")
+    {
+        CHECK(reduce_range(3, 3, 7, std::plus<>{}) == 7);
+        CHECK(reduce_range(std::execution::par, 3, 3, 7, std::plus<>{}, std::plus<>{}) == 7);
+    }
+
+    SECTION("parallel range visits every index once")
+    {
+        std::vector<std::atomic<int>> visits(100000);
+        range(std::execution::par, std::size_t{0}, visits.size(), [&](std::size_t const i) {
+            visits[i]++;
+        }, 1000);
+        CHECK(std::all_of(visits.begin(), visits.end(), [](auto const &count) {
+            return 1 == count;
+        }));
+    }
+
+    SECTION("parallel reduce_range matches sequential reduction")
+    {
+        auto term = [](
+                double const sum,
+                std::size_t const i
+        ) {
+            return sum + 1.0 / (1.0 + i);
+        };
+
+        auto const sequential = reduce_range(std::execution::seq, std::size_t{0}, std::size_t{1000000}, 0.0, term,
+                std::plus<>{}, 1000);
+        auto const parallel = reduce_range(std::execution::par, std::size_t{0}, std::size_t{1000000}, 0.0, term,
+                std::plus<>{}, 1000);
+
+        // Chunk results are combined in order, so results are identical, not just close:
+        CHECK(sequential == parallel);
+        CHECK(parallel == Approx(14.392726722864989));
+    }
+
+    SECTION("parallel range with chunks empty or larger than the range")
+    {
+        for (std::size_t const chunkSize : {0, 1000})
+        {
+            std::vector<std::atomic<int>> visits(100);
+            range(std::execution::par, std::size_t{0}, visits.size(), [&](std::size_t const i) {
+                visits[i]++;
+            }, chunkSize);
+            CHECK(std::all_of(visits.begin(), visits.end(), [](auto const &count) {
+                return 1 == count;
+            }));
+
+            CHECK(reduce_range(std::execution::par, 0, 100, 0, std::plus<>{}, std::plus<>{}, chunkSize) == 4950);
+        }
+    }
+
+    SECTION("parallel reduce_range of booleans")
+    {
+        auto const all = reduce_range(std::execution::par, 0, 100000, true, [](
+                bool const b,
+                int const i
+        ) {
+            return b && i >= 0;
+        }, std::logical_and<>{}, 64);
+        CHECK(all);
+    }
+
+    SECTION("worker pool keeps its workers across calls")
+    {
+        WorkerPool workers;
+        std::vector<std::atomic<int>> visits(1000);
+        for (int call = 0; call < 100; call++)
+        {
+            parallelChunks(workers, visits.size(), 4, [&](
+                    std::size_t const begin,
+                    std::size_t const end,
+                    std::size_t
+            ) {
+                for (auto i = begin; i < end; i++)
+                {
+                    visits[i]++;
+                }
+            });
+        }
+        CHECK(3 == workers.size());
+        CHECK(std::all_of(visits.begin(), visits.end(), [](auto const &count) {
+            return 100 == count;
+        }));
+    }
+
+    SECTION("worker pool rethrows exceptions of chunks")
+    {
+        WorkerPool workers;
+        CHECK_THROWS_AS(parallelChunks(workers, 100, 4, [](
+                std::size_t,
+                std::size_t,
+                std::size_t const chunk
+        ) {
+            if (2 == chunk)
+            {
+                throw std::runtime_error{"chunk failed"};
+            }
+        }), std::runtime_error);
+
+        // The pool stays usable:
+        std::atomic<std::size_t> count{0};
+        parallelChunks(workers, 100, 4, [&](
+                std::size_t const begin,
+                std::size_t const end,
+                std::size_t
+        ) {
+            count += end - begin;
+        });
+        CHECK(100 == count);
+    }
+
+}
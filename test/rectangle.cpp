@@ -4,6 +4,10 @@
 
 #include "catch/catch.hpp"
 #include <orbital/math/Rectangle.h>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<Rectangle<Decimal>>);
+static_assert(std::is_standard_layout_v<Rectangle<Decimal>>);
 
 TEST_CASE("Rectangle", "[math]") // NOLINT
 {
@@ -186,4 +190,11 @@ TEST_CASE("Rectangle", "[math]") // NOLINT
         CHECK(rect.containsTransformed(t, {0.5, 0.5}));
     }
 
+    SECTION("assignment")
+    {
+        Rectangle<Decimal> rect{{0, 0}, 1, 1};
+        rect = Rectangle<Decimal>{{-1, -2}, {3, 4}};
+        CHECK(rect.bottomLeft() == vec{-1, -2});
+        CHECK(rect.topRight() == vec{3, 4});
+    }
 }
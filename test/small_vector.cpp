@@ -0,0 +1,70 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/common/SmallVector.h>
+#include <orbital/common/common.h>
+#include <numeric>
+
+TEST_CASE("SmallVector", "[common]") // NOLINT
+{
+
+    SmallVector<int, 4> vector;
+
+    CHECK(vector.size() == 0);
+    CHECK(!vector.spilled());
+
+    SECTION("stays inline up to its inline capacity")
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            vector.push_back(i);
+        }
+
+        CHECK(vector.size() == 4);
+        CHECK(!vector.spilled());
+    }
+
+    SECTION("exceeding inline capacity spills to heap instead of throwing")
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            CHECK(vector.emplace_back(i) == i);
+        }
+
+        CHECK(vector.spilled());
+        CHECK(vector.size() == 100);
+        CHECK(vector.front() == 0);
+        CHECK(vector.back() == 99);
+        CHECK(vector[50] == 50);
+        CHECK(std::accumulate(vector.begin(), vector.end(), 0) == 4950);
+
+        vector.pop_back();
+        CHECK(vector.size() == 99);
+    }
+
+    SECTION("initializer list longer than inline capacity")
+    {
+        SmallVector<std::string, 2> strings{"a", "b", "c"};
+
+        CHECK(strings.spilled());
+        CHECK(strings.size() == 3);
+        CHECK(strings[2] == "c");
+
+        strings.clear();
+        CHECK(strings.empty());
+    }
+
+    SECTION("appending an own element while spilling")
+    {
+        // Long enough to not fit into the small string buffer, so a moved-from copy would be empty:
+        SmallVector<std::string, 2> strings{"first element of the vector", "second element of the vector"};
+        strings.push_back(strings[0]);
+        CHECK(strings.spilled());
+        CHECK(strings[2] == "first element of the vector");
+        strings.push_back(strings[1]);
+        CHECK(strings[3] == "second element of the vector");
+    }
+
+}
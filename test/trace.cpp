@@ -0,0 +1,104 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/common/trace.h>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+
+std::size_t
+count(
+        char const *name
+)
+{
+    std::size_t result = 0;
+    for (auto const &[thread, events] : Trace::collect())
+    {
+        result += std::count_if(events.begin(), events.end(), [&](TraceEvent const &event) {
+            return std::string_view{name} == event.name;
+        });
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("Trace", "[common]") // NOLINT
+{
+    Trace::clear();
+
+    SECTION("zones are recorded on scope exit")
+    {
+        {
+            TraceZone zone{"outer"};
+            TraceZone inner{"inner"};
+            CHECK(count("outer") == 0);
+        }
+        CHECK(count("outer") == 1);
+        CHECK(count("inner") == 1);
+
+        auto const threads = Trace::collect();
+        for (auto const &[thread, events] : threads)
+        {
+            for (auto const &event : events)
+            {
+                CHECK(event.begin <= event.end);
+            }
+        }
+    }
+
+    SECTION("threads record into their own buffers")
+    {
+        std::thread thread{[] {
+            TraceZone zone{"worker"};
+        }};
+        thread.join();
+        TraceZone{"main"};
+
+        CHECK(count("worker") == 1);
+        CHECK(count("main") == 1);
+    }
+
+    SECTION("buffers of exited threads are reused")
+    {
+        auto spawn = [] {
+            std::thread thread{[] {
+                TraceZone zone{"short-lived"};
+            }};
+            thread.join();
+        };
+        spawn();
+        auto const buffers = Trace::collect().size();
+        for (int i = 0; i < 100; i++)
+        {
+            spawn();
+        }
+        CHECK(Trace::collect().size() == buffers);
+        CHECK(count("short-lived") == 101);
+    }
+
+    SECTION("oldest zones are overwritten when full")
+    {
+        for (std::size_t i = 0; i < TraceBuffer::capacity() + 10; i++)
+        {
+            TraceZone{"zone"};
+        }
+        CHECK(count("zone") == TraceBuffer::capacity());
+    }
+
+    SECTION("export as trace_event JSON")
+    {
+        {
+            TraceZone zone{"exported"};
+        }
+        std::stringstream stream;
+        Trace::write(stream);
+        CHECK(stream.str().find(R"("name":"exported","ph":"X")") != std::string::npos);
+    }
+
+    Trace::clear();
+}
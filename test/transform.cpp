@@ -140,3 +140,57 @@ TEST_CASE("Transformed vectors", "[math]")
         CHECK(v.y == Approx(1));
     }
 }
+
+TEST_CASE("Affine transform", "[math]") // NOLINT
+{
+    Transform<Decimal> transform;
+    transform.rotate(0.3_pi).scale({2, 0.5}).translate({3, -1});
+    std::vector<vec> const vectors{{0, 0}, {1, 0}, {-2, 5}, {1e3, 1e-3}};
+
+    SECTION("inverse reverts the transform")
+    {
+        auto const inverse = transform.inverse();
+        for (auto const &v : vectors)
+        {
+            auto const u = inverse.applied(transform.applied(v));
+            CHECK(u.x == Approx(v.x).margin(1e-9));
+            CHECK(u.y == Approx(v.y).margin(1e-9));
+        }
+    }
+
+    SECTION("composition applies the right hand side first")
+    {
+        Transform<Decimal> other;
+        other.translate({1, 2}).rotate(-0.1_pi);
+        auto const composed = transform * other;
+        for (auto const &v : vectors)
+        {
+            auto const expected = transform.applied(other.applied(v));
+            CHECK(composed.applied(v).x == Approx(expected.x));
+            CHECK(composed.applied(v).y == Approx(expected.y));
+        }
+    }
+
+    SECTION("matrix is equivalent")
+    {
+        for (auto const &v : vectors)
+        {
+            vec const expected = transform.transformation() * vec3{v, 1};
+            CHECK(transform.applied(v).x == Approx(expected.x));
+            CHECK(transform.applied(v).y == Approx(expected.y));
+        }
+    }
+
+    SECTION("batch apply equals single apply, also in place")
+    {
+        std::vector<vec> transformed(vectors.size());
+        transform.applyBatch(vectors, transformed);
+        std::vector<vec> inPlace = vectors;
+        transform.applyBatch(inPlace, inPlace);
+        for (std::size_t i = 0; i < vectors.size(); i++)
+        {
+            CHECK(transformed[i] == transform.applied(vectors[i]));
+            CHECK(inPlace[i] == transformed[i]);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+//
+// Created by jim on 18.10.26.
+//
+
+#include "catch/catch.hpp"
+#include <orbital/common/TripleBuffer.h>
+#include <thread>
+
+TEST_CASE("TripleBuffer", "[common]") // NOLINT
+{
+    TripleBuffer<int> buffer;
+
+    SECTION("nothing to pick up before publishing")
+    {
+        CHECK_FALSE(buffer.update());
+        CHECK(buffer.front() == 0);
+    }
+
+    SECTION("published value is picked up once")
+    {
+        buffer.back() = 3;
+        buffer.publish();
+
+        CHECK(buffer.update());
+        CHECK(buffer.front() == 3);
+        CHECK_FALSE(buffer.update());
+        CHECK(buffer.front() == 3);
+    }
+
+    SECTION("consumer only sees the latest of several published values")
+    {
+        for (int i = 1; i <= 5; i++)
+        {
+            buffer.back() = i;
+            buffer.publish();
+        }
+
+        CHECK(buffer.update());
+        CHECK(buffer.front() == 5);
+    }
+
+    SECTION("values observed by a concurrent consumer never decrease")
+    {
+        constexpr int count = 100000;
+
+        std::thread producer{[&] {
+            for (int i = 1; i <= count; i++)
+            {
+                buffer.back() = i;
+                buffer.publish();
+            }
+        }};
+
+        bool monotonic = true;
+        int last = 0;
+        while (last < count)
+        {
+            if (buffer.update())
+            {
+                monotonic = monotonic && buffer.front() > last;
+                last = buffer.front();
+            }
+        }
+        producer.join();
+
+        CHECK(monotonic);
+        CHECK(last == count);
+    }
+}
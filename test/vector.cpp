@@ -44,4 +44,92 @@ TEST_CASE("Vector", "[math]")
 
         CHECK(v2 == Vector2d<Decimal>{3, 5});
     }
+
+    SECTION("fused expressions")
+    {
+        Vector3d<Decimal> a{1, 2, 3};
+        Vector3d<Decimal> b{4, 5, 6};
+        Vector3d<Decimal> c = a + b * 2 - a / 2;
+
+        CHECK(c == Vector3d<Decimal>{8.5, 11, 13.5});
+        CHECK(-a == Vector3d<Decimal>{-1, -2, -3});
+        CHECK(dot(a, b) == 32);
+        CHECK(dot(a + b, a - b) == dot(a, a) - dot(b, b));
+        CHECK(norm(Vector2d<Decimal>{3, 4}) == 5);
+    }
+
+    SECTION("compound assignment may refer to itself")
+    {
+        Vector<Decimal, 4> v{1, 2, 3, 4};
+        v += v * 2;
+        CHECK(v == Vector<Decimal, 4>{3, 6, 9, 12});
+        v = v - Vector<Decimal, 4>{1, 1, 1, 1};
+        CHECK(v == Vector<Decimal, 4>{2, 5, 8, 11});
+        v *= 0.5;
+        CHECK(v == Vector<Decimal, 4>{1, 2.5, 4, 5.5});
+    }
+
+    SECTION("generic and SIMD evaluation agree")
+    {
+        static_assert(VectorSimd<double, 2>::enabled == VectorSimd<float, 4>::enabled);
+        static_assert(VectorSimd<double, 3>::enabled == (vectorSimdBytes() >= 4 * sizeof(double)));
+        static_assert(!VectorSimd<int, 3>::enabled);
+
+        Vector3d<int> vi{1, 2, 3};
+        Vector3d<float> vf{1, 2, 3};
+        Vector3d<int> ri = vi * 3 - vi;
+        Vector3d<float> rf = vf * 3 - vf;
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            CHECK(ri[i] == rf[i]);
+        }
+        CHECK(dot(vi, vi) == dot(vf, vf));
+    }
+
+    SECTION("integral vectors are divided element-wise")
+    {
+        Vector3d<int> v{7, 8, -9};
+        Vector3d<int> q = v / 2;
+        CHECK(q == Vector3d<int>{3, 4, -4});
+    }
+
+    SECTION("glm conversion")
+    {
+        Vector2d<Decimal> v{vec{1, 2}};
+        CHECK(v.x() == 1);
+        CHECK(v.y() == 2);
+        CHECK(static_cast<vec>(v) == vec{1, 2});
+    }
+
+    SECTION("floating point vectors are divided exactly")
+    {
+        // The reciprocal of 10 is inexact, so multiplying with it rounds differently than dividing:
+        Vector3d<Decimal> v{1, 3, 7};
+        Vector3d<Decimal> q = v / 10;
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            CHECK(q[i] == v[i] / 10);
+        }
+        CHECK(q != Vector3d<Decimal>{v * (1 / 10.0)});
+    }
+
+    SECTION("padding lanes do not take part in reductions")
+    {
+        // The padding lane of 3D packets becomes 0 * inf or 0 / 0, i.e. NaN:
+        Vector3d<Decimal> v{1, 2, 3};
+        Vector3d<float> vf{1, 2, 3};
+        Decimal const infinity = std::numeric_limits<Decimal>::infinity();
+        CHECK(dot(v * infinity, v) == infinity);
+        CHECK(dot(vf * std::numeric_limits<float>::infinity(), vf) == std::numeric_limits<float>::infinity());
+        CHECK(norm(v / 0.0) == infinity);
+        CHECK(norm(vf / 0.0f) == std::numeric_limits<float>::infinity());
+    }
+
+    SECTION("compare")
+    {
+        constexpr Vector3d<Decimal> v{1, 2, 3};
+        static_assert(v == Vector3d<Decimal>{1, 2, 3});
+        static_assert(v != Vector3d<Decimal>{1, 2, 4});
+        static_assert(Vector<Decimal, 3>{1, 2} == Vector<Decimal, 3>{1, 2, 0});
+    }
 }